@@ -154,6 +154,19 @@ CHECK()
     fi
 }
 
+# Save timing results
+#
+# Timings vary from run to run, so they are never compared.  A test that
+# measures performance appends to timing.log (see ../format/compat_timing.h),
+# which is moved here to $TimingDir/<test>-<build>.log.
+SaveTiming()
+{
+    if [ -f timing.log ]; then
+        mkdir -p $TimingDir
+        mv timing.log $TimingDir/$1-$2.log
+    fi
+}
+
 # Build & run test with compiler script
 #
 BUILD()
@@ -169,6 +182,7 @@ BUILD()
             exit 1
         else
             CHECK $2 $3
+            SaveTiming $2 $3
         fi
     else
         echo "*FAILED*"
@@ -527,15 +541,19 @@ TEST_H5R()
 
 # Runs tests for H5S API
 #
+# test_h5s.c benchmarks hyperslab selections of up to 10^4 blocks by
+# default, which is all the releases so far handle in reasonable time; add
+# -DBENCH_MAX_BLOCKS=1000000 to BenchOpts for the full sweep.
+#
 TEST_H5S()
 {
-    compile_options=""
+    compile_options="$BenchOpts"
 
     echo
     echo "################# Testing H5S API #################"
 
     # Run "entire library API" tests
-    TEST test_h5s $compile_options
+    TEST test_h5s "$compile_options"
 
     # Run tests for overriding version of individual API routines
     TESTAPI112 test_h5s "$compile_options" H5Sencode1 "-DH5S_vers=1"
@@ -569,13 +587,13 @@ TEST_H5T()
 #
 TEST_H5Z()
 {
-    compile_options=""
+    compile_options="$BenchOpts"
 
     echo
     echo "################# Testing H5Z API #################"
 
     # Run "entire library API" tests
-    TEST test_h5z $compile_options
+    TEST test_h5z "$compile_options"
 
     # Run tests for overriding version of individual API routines
     TESTAPI test_h5z "$compile_options" H5Z_class1_t "-DH5Z_class_t_vers=1"
@@ -637,6 +655,9 @@ fi
 
 # Definitions
 initfname=.h5compatrc		# personal initialization file
+TimingDir="timing"		# timing results from the tests
+BenchOpts=""			# extra compile options for the benchmarks,
+				# e.g. -DBENCH_MAX_BLOCKS=1000000 (set in $initfname)
 
 # Look for the personal initialization file in $PWD, then in $HOME.
 # If none found, keep preset values.
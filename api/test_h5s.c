@@ -13,10 +13,19 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "hdf5.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../format/compat_timing.h"
 
 /*
  * Basic tests of dataset (H5F) API routines, to verify that API compatibility
  *      is working in the 1.8+ versions of the library
+ *
+ * Also encodes and decodes selections of 10^3 up to BENCH_MAX_BLOCKS
+ *      irregular hyperslab blocks and up to BENCH_MAX_POINTS points, with
+ *      each H5Sencode() this build offers, and checks that every decoded
+ *      selection matches the original.  Build, encode and decode times and
+ *      encoded sizes go to TIMEPATH.
  */
 
 /* 3-D dataset with fixed dimensions */
@@ -25,6 +34,223 @@
 #define SPACE1_DIM2    15
 #define SPACE1_DIM3    13
 
+/* Largest selections benchmarked.  Building or decoding a hyperslab
+ * selection adds its blocks one by one, which takes time quadratic in the
+ * count with the releases so far: with v1.10.8, 10^4 blocks take about 2 s
+ * to select and 3 s to decode per encoding, and 10^5 did not finish in 10
+ * minutes.  So the default stops at 10^4 blocks rather than 10^6; set
+ * BenchOpts="-DBENCH_MAX_BLOCKS=1000000" in .h5compatrc to go further.
+ */
+#ifndef BENCH_MAX_BLOCKS
+#define BENCH_MAX_BLOCKS 10000
+#endif
+#ifndef BENCH_MAX_POINTS
+#define BENCH_MAX_POINTS 1000000
+#endif
+
+/* Columns of the 2-D dataspace the selections are made in */
+#define BENCH_COLS      1024
+
+/* H5Sencode introduced after v 1.6 */
+#if H5_VERS_MINOR > 6
+
+/* Ways to encode a selection */
+#define ENC_API         0       /* H5Sencode(), as this build maps it */
+#define ENC_V1          1       /* H5Sencode1() */
+#define ENC_V2_EARLIEST 2       /* H5Sencode2(), earliest format allowed */
+#define ENC_V2_LATEST   3       /* H5Sencode2(), latest format only */
+#define ENC_NWAYS       4
+
+static const char *enc_names[ENC_NWAYS] = {
+    "api", "v1", "v2_earliest", "v2_latest"
+};
+
+/* Call the encode routine for one way, or return 1 if this build lacks it */
+static herr_t
+encode_call(int how, hid_t sid, void *buf, size_t *nalloc, hid_t fapl)
+{
+    switch(how) {
+        case ENC_API:
+#if defined(H5Sencode_vers) && H5Sencode_vers > 1
+            return(H5Sencode(sid, buf, nalloc, fapl));
+#else /* H5Sencode_vers */
+            fapl = fapl;
+            return(H5Sencode(sid, buf, nalloc));
+#endif /* H5Sencode_vers */
+
+#if H5_VERS_MINOR > 10
+#ifndef H5_NO_DEPRECATED_SYMBOLS
+        case ENC_V1:
+            return(H5Sencode1(sid, buf, nalloc));
+#endif /* H5_NO_DEPRECATED_SYMBOLS */
+
+        case ENC_V2_EARLIEST:
+        case ENC_V2_LATEST:
+            return(H5Sencode2(sid, buf, nalloc, fapl));
+#endif /* H5_VERS_MINOR > 10 */
+
+        default:
+            return(1);
+    } /* end switch */
+} /* end encode_call */
+
+/* Return the blocks or points of a selection in a new buffer */
+static hsize_t *
+get_sel_list(hid_t sid, hssize_t *n)
+{
+    hsize_t *list;
+    int rank = H5Sget_simple_extent_ndims(sid);
+
+    if(H5Sget_select_type(sid) == H5S_SEL_HYPERSLABS) {
+        if((*n = H5Sget_select_hyper_nblocks(sid)) < 0) return(NULL);
+        if((list = (hsize_t *)malloc(sizeof(hsize_t) * (size_t)(*n * 2 * rank) + 1)) == NULL) return(NULL);
+        if(H5Sget_select_hyper_blocklist(sid, (hsize_t)0, (hsize_t)*n, list) < 0) {
+            free(list);
+            return(NULL);
+        } /* end if */
+    } /* end if */
+    else {
+        if((*n = H5Sget_select_elem_npoints(sid)) < 0) return(NULL);
+        if((list = (hsize_t *)malloc(sizeof(hsize_t) * (size_t)(*n * rank) + 1)) == NULL) return(NULL);
+        if(H5Sget_select_elem_pointlist(sid, (hsize_t)0, (hsize_t)*n, list) < 0) {
+            free(list);
+            return(NULL);
+        } /* end if */
+    } /* end else */
+
+    return(list);
+} /* end get_sel_list */
+
+/* Compare a decoded selection with the blocks or points of the original */
+static int
+same_sel(hid_t orig, hid_t copy, const hsize_t *list, hssize_t n)
+{
+    hsize_t *copy_list;
+    hssize_t copy_n;
+    size_t len;
+    int ret;
+
+    if(H5Sget_select_type(orig) != H5Sget_select_type(copy)
+            || H5Sget_select_npoints(orig) != H5Sget_select_npoints(copy))
+        return(0);
+    if((copy_list = get_sel_list(copy, &copy_n)) == NULL)
+        return(0);
+
+    len = (size_t)n * (size_t)H5Sget_simple_extent_ndims(orig);
+    if(H5Sget_select_type(orig) == H5S_SEL_HYPERSLABS)
+        len *= 2;
+    ret = copy_n == n && memcmp(list, copy_list, sizeof(hsize_t) * len) == 0;
+    free(copy_list);
+
+    return(ret);
+} /* end same_sel */
+
+/* Make a selection of n irregular blocks, one per row, or of n points */
+static hid_t
+make_sel(hsize_t n, int points, double *seconds)
+{
+    hid_t sid;
+    hsize_t dims[2], start[2], count[2], block[2];
+    hsize_t *coord, k;
+    herr_t ret = 0;
+
+    dims[0] = n;
+    dims[1] = BENCH_COLS;
+    if((sid = H5Screate_simple(2, dims, NULL)) < 0) return(-1);
+
+    *seconds = compat_time_now();
+    if(points) {
+        if((coord = (hsize_t *)malloc(sizeof(hsize_t) * 2 * (size_t)n)) == NULL) {
+            H5Sclose(sid);
+            return(-1);
+        } /* end if */
+        for(k = 0; k < n; k++) {
+            coord[2 * k] = (k * 7919) % n;
+            coord[2 * k + 1] = (k * 53) % BENCH_COLS;
+        } /* end for */
+        *seconds = compat_time_now();
+        ret = H5Sselect_elements(sid, H5S_SELECT_SET, (size_t)n, coord);
+        *seconds = compat_time_now() - *seconds;
+        free(coord);
+    } /* end if */
+    else {
+        count[0] = count[1] = 1;
+        block[0] = 1;
+        for(k = 0; k < n && ret >= 0; k++) {
+            start[0] = k;
+            start[1] = (k * 37) % (BENCH_COLS / 2);
+            block[1] = 1 + k % 7;
+            ret = H5Sselect_hyperslab(sid, k ? H5S_SELECT_OR : H5S_SELECT_SET, start, NULL, count, block);
+        } /* end for */
+        *seconds = compat_time_now() - *seconds;
+    } /* end else */
+
+    if(ret < 0) {
+        H5Sclose(sid);
+        return(-1);
+    } /* end if */
+
+    return(sid);
+} /* end make_sel */
+
+/* Encode and decode a selection every way this build can, and check it */
+static int
+bench_sel(hsize_t n, int points, hid_t fapl_earliest, hid_t fapl_latest)
+{
+    hid_t sid, dec_sid, fapl;
+    hsize_t *list;
+    hssize_t nlist;
+    unsigned char *buf;
+    size_t nalloc;
+    double t;
+    char prefix[32], metric[64];
+    herr_t ret;
+    int how, ok;
+
+    sprintf(prefix, "%s_%lu", points ? "points" : "hyper", (unsigned long)n);
+    if((sid = make_sel(n, points, &t)) < 0) return(-1);
+    sprintf(metric, "%s_select", prefix);
+    compat_timing("test_h5s", metric, t, "s");
+    if((list = get_sel_list(sid, &nlist)) == NULL) return(-1);
+
+    for(how = 0; how < ENC_NWAYS; how++) {
+        fapl = how == ENC_V2_LATEST ? fapl_latest : fapl_earliest;
+
+        /* Size, then encode */
+        nalloc = 0;
+        t = compat_time_now();
+        if((ret = encode_call(how, sid, NULL, &nalloc, fapl)) < 0) return(-1);
+        if(ret > 0) continue;
+        if((buf = (unsigned char *)malloc(nalloc)) == NULL) return(-1);
+        if(encode_call(how, sid, buf, &nalloc, fapl) < 0) return(-1);
+        t = compat_time_now() - t;
+        sprintf(metric, "%s_%s_encode", prefix, enc_names[how]);
+        compat_timing("test_h5s", metric, t, "s");
+        sprintf(metric, "%s_%s_size", prefix, enc_names[how]);
+        compat_timing("test_h5s", metric, (double)nalloc, "bytes");
+
+        /* Decode and compare */
+        t = compat_time_now();
+        dec_sid = H5Sdecode(buf);
+        t = compat_time_now() - t;
+        free(buf);
+        if(dec_sid < 0) return(-1);
+        sprintf(metric, "%s_%s_decode", prefix, enc_names[how]);
+        compat_timing("test_h5s", metric, t, "s");
+
+        ok = same_sel(sid, dec_sid, list, nlist);
+        H5Sclose(dec_sid);
+        if(!ok) return(-1);
+    } /* end for */
+
+    free(list);
+    H5Sclose(sid);
+
+    return(0);
+} /* end bench_sel */
+
+#endif /* H5_VERS_MINOR > 6 */
+
 
 int
 main(int argc, const char *argv[])
@@ -43,6 +269,8 @@ main(int argc, const char *argv[])
     hid_t            sid;                 /* Dataspace ID */
     int              rank;                /* Logical rank of dataspace */
     hid_t            fapl = -1;           /* File access property list ID */
+    hid_t            fapl_latest = -1;    /* Same, latest format only */
+    hsize_t          nsel;                /* Blocks or points selected */
     hsize_t          dims1[] = {SPACE1_DIM1, SPACE1_DIM2, SPACE1_DIM3};
     size_t           sbuf_size=0, 
                      null_size=0, 
@@ -93,6 +321,23 @@ main(int argc, const char *argv[])
     H5Sclose(sid);
 
 
+    /* Round-trip selections of 10^3, 10^4, ... blocks and points */
+    if((fapl_latest = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto error;
+    if((H5Pset_libver_bounds(fapl_latest, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST)) < 0)
+        goto error;
+
+    for(nsel = 1000; nsel <= BENCH_MAX_BLOCKS; nsel *= 10)
+        if(bench_sel(nsel, 0, fapl, fapl_latest) < 0)
+            goto error;
+    for(nsel = 1000; nsel <= BENCH_MAX_POINTS; nsel *= 10)
+        if(bench_sel(nsel, 1, fapl, fapl_latest) < 0)
+            goto error;
+
+    H5Pclose(fapl_latest);
+    H5Pclose(fapl);
+
+
 #endif /* H5_VERS_MINOR > 6 */
 
     return(0);
@@ -13,36 +13,472 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "hdf5.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../format/compat_timing.h"
+
+/* x86 compilers that can build AVX2 and SSE2 code for single functions
+ * and ask the CPU at run time what it has */
+#if !defined(FILTER_SCALAR) && (defined(__x86_64__) || defined(__i386__)) \
+        && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define FILTER_X86_DISPATCH
+#include <immintrin.h>
+#endif /* FILTER_SCALAR */
 
 /*
- * Basic tests of dataset (H5D) API routines, to verify that API compatibility
+ * Basic tests of filter (H5Z) API routines, to verify that API compatibility
  *      is working in the 1.8+ versions of the library
+ *
+ * The filter registered here byte-shuffles each chunk and compresses it
+ *      with a small LZ coder, so that a chunked dataset can be written and
+ *      read back through it with whichever H5Z_class_t layout the build
+ *      selects.  The data is checked, and the time spent in the filter and
+ *      in the rest of the library goes to TIMEPATH.
+ *
+ * The shuffle of 4-byte elements uses AVX2 or SSE2 when the compiler can
+ *      target them and the CPU running the test has them, picked at run
+ *      time with __builtin_cpu_supports(); otherwise, or when built with
+ *      -DFILTER_SCALAR, it is portable C.  The vector width used goes to
+ *      TIMEPATH as shuffle_bits.
  */
 
 #define FILENAME        "compat_h5z.h5"
 #define DSET_NAME       "/Dataset"
+#define PLAIN_NAME      "/Unfiltered"
+
+#define FILTER_ID       365
+
+/* Dataset of NELMTS integers in chunks of CHUNK_NELMTS */
+#ifndef NELMTS
+#define NELMTS          1048576
+#endif
+#define CHUNK_NELMTS    4096
+#define NCHUNKS         ((NELMTS + CHUNK_NELMTS - 1) / CHUNK_NELMTS)
+
+/* The H5Z_class_t layout this build registers the filter with */
+#if defined(H5Z_class_t_vers) && H5Z_class_t_vers > 1
+#define FILTER_LAYOUT   2
+#else /* H5Z_class_t_vers */
+#define FILTER_LAYOUT   1
+#endif /* H5Z_class_t_vers */
+
+/* LZ coder: a control byte below 128 starts a run of c + 1 literal bytes;
+ * otherwise it is a match of c - 128 + LZ_MIN_MATCH bytes, followed by a
+ * 2-byte little-endian offset back into the output.
+ */
+#define LZ_MIN_MATCH    4
+#define LZ_MAX_MATCH    (LZ_MIN_MATCH + 127)
+#define LZ_MAX_LITERAL  128
+#define LZ_MAX_OFFSET   65535
+#define LZ_HASH_BITS    12
+#define LZ_HASH(p)      (((((unsigned)(p)[0] | ((unsigned)(p)[1] << 8) | ((unsigned)(p)[2] << 16) | ((unsigned)(p)[3] << 24)) * 2654435761U) >> (32 - LZ_HASH_BITS)) & ((1 << LZ_HASH_BITS) - 1))
+
+/* Largest encoded chunk: the size header and one control byte per literal run */
+#define LZ_BOUND(n)     (4 + (n) + (n) / LZ_MAX_LITERAL + 1)
+
+/* Filter calls and the time spent in them */
+static struct {
+    unsigned encode_calls, decode_calls;
+    double encode_seconds, decode_seconds;
+} filter_stats;
+
+/* Shuffle kernels for 4-byte elements.  Each converts as many leading
+ * elements of nelmts as fit its vector width and returns how many; the
+ * byte planes are nelmts bytes apart.  The rest is left to the C loops.
+ */
+typedef size_t (*shuffle4_func_t)(const unsigned char *src, unsigned char *dst, size_t nelmts);
 
-/* Empty filter function */
+static size_t
+shuffle4_scalar(const unsigned char *src, unsigned char *dst, size_t nelmts)
+{
+    src = src;
+    dst = dst;
+    nelmts = nelmts;
+
+    return(0);
+} /* end shuffle4_scalar */
+
+#ifdef FILTER_X86_DISPATCH
+__attribute__((target("sse2"))) static size_t
+shuffle4_sse2(const unsigned char *src, unsigned char *dst, size_t nelmts)
+{
+    __m128i v[4], t[4];
+    size_t e;
+    int k;
+
+    for(e = 0; e + 16 <= nelmts; e += 16) {
+        for(k = 0; k < 4; k++)
+            v[k] = _mm_loadu_si128((const __m128i *)(src + 4 * e + 16 * k));
+        t[0] = _mm_unpacklo_epi8(v[0], v[1]);
+        t[1] = _mm_unpackhi_epi8(v[0], v[1]);
+        t[2] = _mm_unpacklo_epi8(v[2], v[3]);
+        t[3] = _mm_unpackhi_epi8(v[2], v[3]);
+        v[0] = _mm_unpacklo_epi8(t[0], t[1]);
+        v[1] = _mm_unpackhi_epi8(t[0], t[1]);
+        v[2] = _mm_unpacklo_epi8(t[2], t[3]);
+        v[3] = _mm_unpackhi_epi8(t[2], t[3]);
+        t[0] = _mm_unpacklo_epi8(v[0], v[1]);
+        t[1] = _mm_unpackhi_epi8(v[0], v[1]);
+        t[2] = _mm_unpacklo_epi8(v[2], v[3]);
+        t[3] = _mm_unpackhi_epi8(v[2], v[3]);
+        for(k = 0; k < 2; k++) {
+            _mm_storeu_si128((__m128i *)(dst + 2 * k * nelmts + e), _mm_unpacklo_epi64(t[k], t[k + 2]));
+            _mm_storeu_si128((__m128i *)(dst + (2 * k + 1) * nelmts + e), _mm_unpackhi_epi64(t[k], t[k + 2]));
+        } /* end for */
+    } /* end for */
+
+    return(e);
+} /* end shuffle4_sse2 */
+
+__attribute__((target("sse2"))) static size_t
+unshuffle4_sse2(const unsigned char *src, unsigned char *dst, size_t nelmts)
+{
+    __m128i p[4], t[4];
+    size_t e;
+    int k;
+
+    for(e = 0; e + 16 <= nelmts; e += 16) {
+        for(k = 0; k < 4; k++)
+            p[k] = _mm_loadu_si128((const __m128i *)(src + k * nelmts + e));
+        t[0] = _mm_unpacklo_epi8(p[0], p[1]);
+        t[1] = _mm_unpackhi_epi8(p[0], p[1]);
+        t[2] = _mm_unpacklo_epi8(p[2], p[3]);
+        t[3] = _mm_unpackhi_epi8(p[2], p[3]);
+        _mm_storeu_si128((__m128i *)(dst + 4 * e), _mm_unpacklo_epi16(t[0], t[2]));
+        _mm_storeu_si128((__m128i *)(dst + 4 * e + 16), _mm_unpackhi_epi16(t[0], t[2]));
+        _mm_storeu_si128((__m128i *)(dst + 4 * e + 32), _mm_unpacklo_epi16(t[1], t[3]));
+        _mm_storeu_si128((__m128i *)(dst + 4 * e + 48), _mm_unpackhi_epi16(t[1], t[3]));
+    } /* end for */
+
+    return(e);
+} /* end unshuffle4_sse2 */
+
+/* The AVX2 unpacks work on each 128-bit lane, so the low lanes carry
+ * elements e to e + 15 and the high lanes e + 16 to e + 31 */
+__attribute__((target("avx2"))) static size_t
+shuffle4_avx2(const unsigned char *src, unsigned char *dst, size_t nelmts)
+{
+    __m256i x[4], v[4], t[4];
+    size_t e;
+    int k;
+
+    for(e = 0; e + 32 <= nelmts; e += 32) {
+        for(k = 0; k < 4; k++)
+            x[k] = _mm256_loadu_si256((const __m256i *)(src + 4 * e + 32 * k));
+        v[0] = _mm256_permute2x128_si256(x[0], x[2], 0x20);
+        v[1] = _mm256_permute2x128_si256(x[0], x[2], 0x31);
+        v[2] = _mm256_permute2x128_si256(x[1], x[3], 0x20);
+        v[3] = _mm256_permute2x128_si256(x[1], x[3], 0x31);
+        t[0] = _mm256_unpacklo_epi8(v[0], v[1]);
+        t[1] = _mm256_unpackhi_epi8(v[0], v[1]);
+        t[2] = _mm256_unpacklo_epi8(v[2], v[3]);
+        t[3] = _mm256_unpackhi_epi8(v[2], v[3]);
+        v[0] = _mm256_unpacklo_epi8(t[0], t[1]);
+        v[1] = _mm256_unpackhi_epi8(t[0], t[1]);
+        v[2] = _mm256_unpacklo_epi8(t[2], t[3]);
+        v[3] = _mm256_unpackhi_epi8(t[2], t[3]);
+        t[0] = _mm256_unpacklo_epi8(v[0], v[1]);
+        t[1] = _mm256_unpackhi_epi8(v[0], v[1]);
+        t[2] = _mm256_unpacklo_epi8(v[2], v[3]);
+        t[3] = _mm256_unpackhi_epi8(v[2], v[3]);
+        _mm256_storeu_si256((__m256i *)(dst + e), _mm256_unpacklo_epi64(t[0], t[2]));
+        _mm256_storeu_si256((__m256i *)(dst + nelmts + e), _mm256_unpackhi_epi64(t[0], t[2]));
+        _mm256_storeu_si256((__m256i *)(dst + 2 * nelmts + e), _mm256_unpacklo_epi64(t[1], t[3]));
+        _mm256_storeu_si256((__m256i *)(dst + 3 * nelmts + e), _mm256_unpackhi_epi64(t[1], t[3]));
+    } /* end for */
+
+    return(e);
+} /* end shuffle4_avx2 */
+
+__attribute__((target("avx2"))) static size_t
+unshuffle4_avx2(const unsigned char *src, unsigned char *dst, size_t nelmts)
+{
+    __m256i p[4], t[4], v[4];
+    size_t e;
+    int k;
+
+    for(e = 0; e + 32 <= nelmts; e += 32) {
+        for(k = 0; k < 4; k++)
+            p[k] = _mm256_loadu_si256((const __m256i *)(src + k * nelmts + e));
+        t[0] = _mm256_unpacklo_epi8(p[0], p[1]);
+        t[1] = _mm256_unpackhi_epi8(p[0], p[1]);
+        t[2] = _mm256_unpacklo_epi8(p[2], p[3]);
+        t[3] = _mm256_unpackhi_epi8(p[2], p[3]);
+        v[0] = _mm256_unpacklo_epi16(t[0], t[2]);
+        v[1] = _mm256_unpackhi_epi16(t[0], t[2]);
+        v[2] = _mm256_unpacklo_epi16(t[1], t[3]);
+        v[3] = _mm256_unpackhi_epi16(t[1], t[3]);
+        _mm256_storeu_si256((__m256i *)(dst + 4 * e), _mm256_permute2x128_si256(v[0], v[1], 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 4 * e + 32), _mm256_permute2x128_si256(v[2], v[3], 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + 4 * e + 64), _mm256_permute2x128_si256(v[0], v[1], 0x31));
+        _mm256_storeu_si256((__m256i *)(dst + 4 * e + 96), _mm256_permute2x128_si256(v[2], v[3], 0x31));
+    } /* end for */
+
+    return(e);
+} /* end unshuffle4_avx2 */
+#endif /* FILTER_X86_DISPATCH */
+
+/* The kernels this CPU runs, and their vector width in bits */
+static shuffle4_func_t shuffle4 = shuffle4_scalar;
+static shuffle4_func_t unshuffle4 = shuffle4_scalar;
+static int shuffle_bits = 0;
+
+/* Pick the widest kernels the CPU supports */
+static void
+pick_shuffle(void)
+{
+#ifdef FILTER_X86_DISPATCH
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        shuffle4 = shuffle4_avx2;
+        unshuffle4 = unshuffle4_avx2;
+        shuffle_bits = 256;
+    } /* end if */
+    else if(__builtin_cpu_supports("sse2")) {
+        shuffle4 = shuffle4_sse2;
+        unshuffle4 = unshuffle4_sse2;
+        shuffle_bits = 128;
+    } /* end if */
+#endif /* FILTER_X86_DISPATCH */
+} /* end pick_shuffle */
+
+/* Split elements of elmt_size bytes into byte planes */
+static void
+shuffle(const unsigned char *src, unsigned char *dst, size_t nbytes, size_t elmt_size)
+{
+    size_t nelmts = nbytes / elmt_size;
+    size_t b, e, done = 0;
+
+    if(elmt_size == 4)
+        done = shuffle4(src, dst, nelmts);
+    for(b = 0; b < elmt_size; b++)
+        for(e = done; e < nelmts; e++)
+            dst[b * nelmts + e] = src[e * elmt_size + b];
+    memcpy(dst + nelmts * elmt_size, src + nelmts * elmt_size, nbytes - nelmts * elmt_size);
+} /* end shuffle */
+
+/* Put byte planes back together */
+static void
+unshuffle(const unsigned char *src, unsigned char *dst, size_t nbytes, size_t elmt_size)
+{
+    size_t nelmts = nbytes / elmt_size;
+    size_t b, e, done = 0;
+
+    if(elmt_size == 4)
+        done = unshuffle4(src, dst, nelmts);
+    for(b = 0; b < elmt_size; b++)
+        for(e = done; e < nelmts; e++)
+            dst[e * elmt_size + b] = src[b * nelmts + e];
+    memcpy(dst + nelmts * elmt_size, src + nelmts * elmt_size, nbytes - nelmts * elmt_size);
+} /* end unshuffle */
+
+/* Append n literal bytes to out at op, in runs of at most LZ_MAX_LITERAL */
+static size_t
+lz_literals(const unsigned char *src, size_t n, unsigned char *out, size_t op)
+{
+    size_t len;
+
+    while(n > 0) {
+        len = n < LZ_MAX_LITERAL ? n : LZ_MAX_LITERAL;
+        out[op++] = (unsigned char)(len - 1);
+        memcpy(out + op, src, len);
+        op += len;
+        src += len;
+        n -= len;
+    }
+
+    return(op);
+} /* end lz_literals */
+
+/* Compress n bytes into out, which holds at least LZ_BOUND(n) - 4 bytes */
+static size_t
+lz_encode(const unsigned char *in, size_t n, unsigned char *out)
+{
+    static size_t table[1 << LZ_HASH_BITS];     /* Last position + 1 of each hash */
+    size_t ip = 0, op = 0, lit = 0;
+    size_t ref, len, off, h;
+
+    memset(table, 0, sizeof(table));
+    while(ip + LZ_MIN_MATCH <= n) {
+        h = LZ_HASH(in + ip);
+        ref = table[h];
+        table[h] = ip + 1;
+        if(ref > 0 && ip - (ref - 1) <= LZ_MAX_OFFSET && memcmp(in + ref - 1, in + ip, LZ_MIN_MATCH) == 0) {
+            ref--;
+            len = LZ_MIN_MATCH;
+            while(len < LZ_MAX_MATCH && ip + len < n && in[ref + len] == in[ip + len])
+                len++;
+
+            op = lz_literals(in + lit, ip - lit, out, op);
+            off = ip - ref;
+            out[op++] = (unsigned char)(128 + len - LZ_MIN_MATCH);
+            out[op++] = (unsigned char)(off & 0xff);
+            out[op++] = (unsigned char)(off >> 8);
+            ip += len;
+            lit = ip;
+        } /* end if */
+        else
+            ip++;
+    } /* end while */
+
+    return(lz_literals(in + lit, n - lit, out, op));
+} /* end lz_encode */
+
+/* Expand n bytes of in into exactly outlen bytes of out */
+static int
+lz_decode(const unsigned char *in, size_t n, unsigned char *out, size_t outlen)
+{
+    size_t ip = 0, op = 0, len, off;
+    unsigned c;
+
+    while(ip < n) {
+        c = in[ip++];
+        if(c < 128) {
+            len = c + 1;
+            if(ip + len > n || op + len > outlen) return(-1);
+            memcpy(out + op, in + ip, len);
+            ip += len;
+            op += len;
+        } /* end if */
+        else {
+            len = c - 128 + LZ_MIN_MATCH;
+            if(ip + 2 > n) return(-1);
+            off = (size_t)in[ip] | ((size_t)in[ip + 1] << 8);
+            ip += 2;
+            if(off == 0 || off > op || op + len > outlen) return(-1);
+            /* Byte by byte, as a match may overlap itself */
+            for(; len > 0; len--, op++)
+                out[op] = out[op - off];
+        } /* end else */
+    } /* end while */
+
+    return(op == outlen ? 0 : -1);
+} /* end lz_decode */
+
+/* Shuffle and compress a chunk; cd_values[0] is the element size */
 static size_t
 filter_func(unsigned int flags, size_t cd_nelmts,
         const unsigned int cd_values[], size_t nbytes, size_t *buf_size,
         void **buf)
 {
-    /* Prevent compiler warning */
-    flags = flags;
-    cd_nelmts = cd_nelmts;
-    cd_values = cd_values;
-    buf_size = buf_size;
-    buf = buf;
+    size_t elmt_size = (cd_nelmts > 0 && cd_values[0] > 0) ? cd_values[0] : 1;
+    unsigned char *in = (unsigned char *)*buf;
+    unsigned char *tmp = NULL, *out = NULL;
+    size_t out_size, ret;
+    double t = compat_time_now();
+
+    if(flags & H5Z_FLAG_REVERSE) {
+        /* Decompress, then unshuffle */
+        if(nbytes < 4) return(0);
+        out_size = (size_t)in[0] | ((size_t)in[1] << 8) | ((size_t)in[2] << 16) | ((size_t)in[3] << 24);
+        if((tmp = (unsigned char *)malloc(out_size + 1)) == NULL
+                || (out = (unsigned char *)malloc(out_size + 1)) == NULL
+                || lz_decode(in + 4, nbytes - 4, tmp, out_size) < 0) {
+            free(tmp);
+            free(out);
+            return(0);
+        } /* end if */
+        unshuffle(tmp, out, out_size, elmt_size);
+        ret = out_size;
+        filter_stats.decode_calls++;
+        filter_stats.decode_seconds += compat_time_now() - t;
+    } /* end if */
+    else {
+        /* Shuffle, then compress behind a 4-byte size header */
+        out_size = LZ_BOUND(nbytes);
+        if((tmp = (unsigned char *)malloc(nbytes + 1)) == NULL
+                || (out = (unsigned char *)malloc(out_size)) == NULL) {
+            free(tmp);
+            free(out);
+            return(0);
+        } /* end if */
+        shuffle(in, tmp, nbytes, elmt_size);
+        out[0] = (unsigned char)(nbytes & 0xff);
+        out[1] = (unsigned char)((nbytes >> 8) & 0xff);
+        out[2] = (unsigned char)((nbytes >> 16) & 0xff);
+        out[3] = (unsigned char)((nbytes >> 24) & 0xff);
+        ret = 4 + lz_encode(tmp, nbytes, out + 4);
+        filter_stats.encode_calls++;
+        filter_stats.encode_seconds += compat_time_now() - t;
+    } /* end else */
 
-    return(nbytes);
+    free(tmp);
+    free(*buf);
+    *buf = out;
+    *buf_size = out_size;
+
+    return(ret);
 } /* end filter_func */
 
+/* Create and write a chunked dataset, returning the seconds it took */
+static double
+write_dset(hid_t fid, const char *name, hid_t sid, hid_t dcpl, const int *buf)
+{
+    hid_t       dsid;           /* Dataset ID */
+    double      t = compat_time_now();
+
+#if defined(H5Dcreate_vers) && H5Dcreate_vers > 1
+    if((dsid = H5Dcreate(fid, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT)) < 0) return(-1.0);
+#else /* H5Dcreate_vers */
+    if((dsid = H5Dcreate(fid, name, H5T_NATIVE_INT, sid, dcpl)) < 0) return(-1.0);
+#endif /* H5Dcreate_vers */
+    if(H5Dwrite(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) return(-1.0);
+    if(H5Dclose(dsid) < 0) return(-1.0);
+
+    return(compat_time_now() - t);
+} /* end write_dset */
+
+/* Read a dataset and check it, returning the seconds the read took */
+static double
+read_dset(hid_t fid, const char *name, int *buf, double *storage)
+{
+    hid_t       dsid;           /* Dataset ID */
+    double      t;
+    int         k, bad = 0;
+
+#if defined(H5Dopen_vers) && H5Dopen_vers > 1
+    if((dsid = H5Dopen(fid, name, H5P_DEFAULT)) < 0) return(-1.0);
+#else /* H5Dopen_vers */
+    if((dsid = H5Dopen(fid, name)) < 0) return(-1.0);
+#endif /* H5Dopen_vers */
+    *storage = (double)H5Dget_storage_size(dsid);
+
+    memset(buf, 0, sizeof(int) * NELMTS);
+    t = compat_time_now();
+    if(H5Dread(dsid, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) return(-1.0);
+    t = compat_time_now() - t;
+    if(H5Dclose(dsid) < 0) return(-1.0);
+
+    for(k = 0; k < NELMTS; k++)
+        bad |= buf[k] != k / 16;
+
+    return(bad ? -1.0 : t);
+} /* end read_dset */
+
+/* Record one measurement, named after the filter layout */
+static void
+report(const char *metric, double value, const char *unit)
+{
+    char name[64];
+
+    sprintf(name, "class%d_%s", FILTER_LAYOUT, metric);
+    compat_timing("test_h5z", name, value, unit);
+} /* end report */
+
 int
 main(int argc, const char *argv[])
 {
+    hid_t       fid;            /* File ID */
+    hid_t       sid;            /* Dataspace ID */
     hid_t       dcpl;           /* Dataset Creation Property List */
+    hid_t       plain_dcpl;     /* Same, without the filter */
     H5Z_class_t filter_class;   /* Filter class */
+    unsigned int cd_values[1];  /* Filter client data: element size */
+    hsize_t     dims[1], chunk[1];
+    double      plain_write, plain_read, filter_write, filter_read, storage;
+    double      nbytes = (double)NELMTS * sizeof(int);
+    int         *buf;
+    int         k;
 
     /* Shut compiler up */
     argc = argc;
@@ -57,7 +493,7 @@ main(int argc, const char *argv[])
     if((dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
 
     /* Create filter */
-    filter_class.id = 365;
+    filter_class.id = FILTER_ID;
     filter_class.name = "compat_filter";
     filter_class.can_apply = NULL;
     filter_class.set_local = NULL;
@@ -69,12 +505,57 @@ main(int argc, const char *argv[])
 #endif /* H5Z_class_t_vers */
 
     /* Register the filter */
+    pick_shuffle();
     if(H5Zregister(&filter_class) < 0) goto error;
 
     /* Add the filter to the property list */
-    if(H5Pset_filter(dcpl, 365, 0, (size_t)0, NULL) < 0) goto error;
+    cd_values[0] = (unsigned int)sizeof(int);
+    if(H5Pset_filter(dcpl, FILTER_ID, 0, (size_t)1, cd_values) < 0) goto error;
+
+    /* Chunk both datasets the same way */
+    dims[0] = NELMTS;
+    chunk[0] = CHUNK_NELMTS;
+    if(H5Pset_chunk(dcpl, 1, chunk) < 0) goto error;
+    if((plain_dcpl = H5Pcreate(H5P_DATASET_CREATE)) < 0) goto error;
+    if(H5Pset_chunk(plain_dcpl, 1, chunk) < 0) goto error;
+
+    /* A slow ramp, which shuffles into long runs */
+    if((buf = (int *)malloc(sizeof(int) * NELMTS)) == NULL) goto error;
+    for(k = 0; k < NELMTS; k++)
+        buf[k] = k / 16;
+
+    /* Write the datasets, then read them back */
+    if((fid = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT)) < 0) goto error;
+    if((sid = H5Screate_simple(1, dims, NULL)) < 0) goto error;
+    if((plain_write = write_dset(fid, PLAIN_NAME, sid, plain_dcpl, buf)) < 0) goto error;
+    if((filter_write = write_dset(fid, DSET_NAME, sid, dcpl, buf)) < 0) goto error;
+    if(H5Sclose(sid) < 0) goto error;
+    if(H5Fclose(fid) < 0) goto error;
+
+    if((fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT)) < 0) goto error;
+    if((plain_read = read_dset(fid, PLAIN_NAME, buf, &storage)) < 0) goto error;
+    if((filter_read = read_dset(fid, DSET_NAME, buf, &storage)) < 0) goto error;
+    if(H5Fclose(fid) < 0) goto error;
+
+    /* Every chunk went through the filter once each way */
+    if(filter_stats.encode_calls != NCHUNKS || filter_stats.decode_calls != NCHUNKS) goto error;
+
+    /* The library's time per chunk outside the filter, and the same
+     * for the unfiltered dataset to compare with */
+    report("write", compat_mbps(nbytes, filter_write), "MB/s");
+    report("read", compat_mbps(nbytes, filter_read), "MB/s");
+    report("encode", compat_mbps(nbytes, filter_stats.encode_seconds), "MB/s");
+    report("decode", compat_mbps(nbytes, filter_stats.decode_seconds), "MB/s");
+    report("ratio", storage > 0.0 ? nbytes / storage : 0.0, "x");
+    report("shuffle_bits", (double)shuffle_bits, "bits");
+    report("write_chunk", (filter_write - filter_stats.encode_seconds) * 1000000.0 / NCHUNKS, "us/chunk");
+    report("read_chunk", (filter_read - filter_stats.decode_seconds) * 1000000.0 / NCHUNKS, "us/chunk");
+    report("plain_write_chunk", plain_write * 1000000.0 / NCHUNKS, "us/chunk");
+    report("plain_read_chunk", plain_read * 1000000.0 / NCHUNKS, "us/chunk");
 
     /* Close */
+    free(buf);
+    if(H5Pclose(plain_dcpl) < 0) goto error;
     if(H5Pclose(dcpl) < 0) goto error;
 
 
@@ -83,4 +564,3 @@ main(int argc, const char *argv[])
 error:
     return(1);
 }
-
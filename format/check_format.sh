@@ -60,6 +60,9 @@ h5cc16="/mnt/scr1/pre-release/hdf5/v16/$HOST_NAME/bin/h5cc"
 
 # Definitions
 initfname=.h5compatrc		# personal initialization file
+BenchOpts=""			# extra compile options for the benchmarks,
+				# e.g. -DRAW_NELMTS=268435456 (set in $initfname)
+NativeCC=cc			# compiler for h5census.c, which needs no HDF5
 
 # Look for the personal initialization file in $PWD, then in $HOME.
 # If none found, keep preset values.
@@ -290,6 +293,44 @@ read_ref_compat_dev()
     fi
 }
 
+#### Build a reader with every library version ####
+# $1: reader source, $2: prefix for the executables, which are named
+# $2_16.out, $2_18.out, $2_110.out, $2_112.out, $2_114.out and $2_dev.out.
+# $BenchOpts is passed along so that .h5compatrc can scale the benchmarks.
+BuildReaders()
+{
+    $h5cc16 $BenchOpts -o $2_16.out $1
+    $h5cc18 -DH5_USE_16_API $BenchOpts -o $2_18.out $1
+    $h5cc110 -DH5_USE_16_API $BenchOpts -o $2_110.out $1
+    $h5cc112 -DH5_USE_16_API $BenchOpts -o $2_112.out $1
+    $h5cc114 -DH5_USE_16_API $BenchOpts -o $2_114.out $1
+    $h5ccdev -DH5_USE_16_API $BenchOpts -o $2_dev.out $1
+}
+
+#### Read with every library version ####
+# $1: prefix of the executables from BuildReaders, $2: text appended to
+# each section header.  The remaining arguments are passed to the readers.
+# $Readers, when set, lists the versions to read with instead of all.
+ReadAll()
+{
+    Prefix=$1
+    Label=$2
+    shift 2
+    for V in ${Readers:-16:v1.6 18:v1.8 110:v1.10 112:v1.12 114:v1.14 dev:vdev}; do
+        if [ -s errors.log ]; then
+            echo >> errors.log
+            echo >> errors.log
+        fi
+        echo "========= Reading with ${V#*:}$Label =========" >> errors.log
+        echo >> errors.log
+        if [ -x ${Prefix}_${V%%:*}.out ]; then
+            ./${Prefix}_${V%%:*}.out "$@" 2>/dev/null
+        else
+            echo "messed up compiling $Prefix with ${V#*:}"
+        fi
+    done
+}
+
 #### Check Errors ####
 CheckErrors()
 {
@@ -375,6 +416,7 @@ RunTest()
     echo
     echo "#################  $1  #################"
     ./gen_compat.out
+    SizeReport compat.h5 $1 before
     $CC tests/$Test
     #$h5cc18 tests/$Test
     if [ $? -ne 0 ]
@@ -383,12 +425,15 @@ RunTest()
         exit 1
     fi
     ./a.out
+    SizeReport compat.h5 $1 after
+    Census compat.h5 $1
     read16
     read18
     read110
     read112
     read114
     readdev
+    SaveTiming $1
     CheckErrors $1
     rm errors.log
 }
@@ -406,6 +451,7 @@ Run_ref_compat_Test()
     echo
     echo "#################  $1  #################"
     ./gen_ref_compat.out
+    SizeReport ref_compat.h5 $1 before
     $CC tests/$Test
     if [ $? -ne 0 ]
     then
@@ -413,6 +459,8 @@ Run_ref_compat_Test()
         exit 1
     fi
     ./a.out
+    SizeReport ref_compat.h5 $1 after
+    Census ref_compat.h5 $1
     read_ref_compat_16
     read_ref_compat_18
     read_ref_compat_110
@@ -428,6 +476,843 @@ Run_ref_compat_Test()
 }
 
 
+#### Run reference scaling test ####
+# tests/t_ref_scale.c adds many object and region references to
+# ref_compat.h5 with the old reference types and, from v1.12 on, with the
+# revised type as well.  read_ref_scale_compat.c, built with every library
+# version, follows them each way that version can and times it.  The
+# revised datasets only exist when the writer is v1.12 or newer, so the
+# expected output is t_ref_scale1 for a test file created by $h5cc18 or
+# $h5cc110 and t_ref_scale2 for the newer versions.
+Run_ref_scale_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_ref_scale_compat.c read_ref_scale
+    ./gen_ref_compat.out
+    SizeReport ref_compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    ./a.out
+    SizeReport ref_compat.h5 $1 after
+    Census ref_compat.h5 $1
+    ReadAll read_ref_scale ""
+    rm -f read_ref_scale_*.out
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" -o "$CC" = "$h5cc110" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run hyperslab test ####
+# gen_hyper_compat.c, built with v1.8, creates hyper_compat.h5 with region
+# references to selections within 2^32 elements of a 4.3-billion-element
+# dataset.  tests/t_hyper.c adds references to selections past 2^32, which
+# v1.10 can create for regular hyperslabs and v1.12 and later for all of
+# them, so the expected output is t_hyper1 for a test file created by
+# $h5cc18, t_hyper2 for $h5cc110 and t_hyper3 for the newer versions.
+# Every reference is also stored many times over, and
+# read_hyper_compat.c, built with v1.8 and later (it needs the v1.8 API),
+# times decoding them.
+Run_hyper_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    $h5cc18 $BenchOpts -o read_hyper_18.out read_hyper_compat.c
+    $h5cc110 $BenchOpts -o read_hyper_110.out read_hyper_compat.c
+    $h5cc112 $BenchOpts -o read_hyper_112.out read_hyper_compat.c
+    $h5cc114 $BenchOpts -o read_hyper_114.out read_hyper_compat.c
+    $h5ccdev $BenchOpts -o read_hyper_dev.out read_hyper_compat.c
+    ./gen_hyper_compat.out
+    SizeReport hyper_compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    ./a.out
+    SizeReport hyper_compat.h5 $1 after
+    Census hyper_compat.h5 $1
+    Readers="18:v1.8 110:v1.10 112:v1.12 114:v1.14 dev:vdev"
+    ReadAll read_hyper ""
+    Readers=""
+    rm -f read_hyper_*.out hyper_compat.h5
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    elif [ "$CC" = "$h5cc110" ]; then
+        CheckErrors $12
+    else
+        CheckErrors $13
+    fi
+    rm errors.log
+}
+
+
+#### Format census ####
+# h5census.c reads the file's structures directly, without any HDF5
+# library, and lists the format versions and byte counts of every object.
+# It runs on the modified test file so that a reader failure can be traced
+# to the structure that caused it; the census goes to
+# $CensusDir/<test>-<writer release>.txt.
+Census()
+{
+    if [ -x ./h5census.out ]
+    then
+        mkdir -p $CensusDir
+        ./h5census.out $1 > $CensusDir/$2-$CCTAG.txt
+    fi
+}
+
+
+#### File size report ####
+# SizeReport <file> <test> before|after runs size_compat.c, built with the
+# writing library, on a file the test creates or modifies; the sizes go to
+# the timing results.  Run it before and after a lane modifies a file, or
+# only after for a file the test just creates.  Files other than compat.h5
+# are labelled with their name, so that one lane can report several.  A
+# file the writer did not make is skipped.
+SizeReport()
+{
+    if [ -f $1 ]; then
+        if [ "$1" = "compat.h5" ]; then
+            ./size_compat.out $1 $2 $3
+        else
+            ./size_compat.out $1 $2 $3 ${1%.h5}
+        fi
+    fi
+}
+
+
+#### Wait for a writer started in the background ####
+# Wait until the writer with process ID $2 has created the marker file $1.
+# Returns 1 if the writer exits first or $ReadyWait seconds go by, so that
+# a writer that dies cannot hang the whole run.
+ReadyWait=120
+WaitReady()
+{
+    Waited=0
+    while [ ! -f $1 ]; do
+        if ! kill -0 $2 2>/dev/null || [ $Waited -ge $ReadyWait ]
+        then
+            kill $2 2>/dev/null
+            wait $2 2>/dev/null
+            echo "writer did not create $1"
+            return 1
+        fi
+        sleep 1
+        Waited=`expr $Waited + 1`
+    done
+    return 0
+}
+
+
+#### Save timing results ####
+# Timings vary from run to run, so they are kept out of errors.log.  Any
+# test that measures performance appends to timing.log, which is moved
+# here to $TimingDir/<test>-<writer release>.log.
+SaveTiming()
+{
+    if [ -f timing.log ]
+    then
+        mkdir -p $TimingDir
+        mv timing.log $TimingDir/$1-$CCTAG.log
+    fi
+}
+
+
+#### Run chunk index test ####
+# tests/t_chunk_index.c adds one dataset per chunk index type to compat.h5,
+# and read_chunk_compat.c, built with every library version, reads them
+# whole and a corner of every chunk.  v1.8 writes all of them with a
+# version 1 B-tree; later writers use the newer index types, which v1.8
+# cannot open.  Therefore the expected output is t_chunk_index1 for a test
+# file created by $h5cc18 and t_chunk_index2 for the newer versions.
+Run_chunk_index_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_chunk_compat.c read_chunk
+    ./gen_compat.out
+    SizeReport compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    ./a.out
+    SizeReport compat.h5 $1 after
+    Census compat.h5 $1
+    ReadAll read_chunk ""
+    rm -f read_chunk_*.out
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run filter test ####
+# tests/t_filters.c adds datasets written through each filter pipeline to
+# compat.h5, keeping the format v1.6 can read.  read_filter_compat.c, built
+# with every library version, verifies them and times the decoding.
+Run_filter_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_filter_compat.c read_filter
+    ./gen_compat.out
+    SizeReport compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    ./a.out
+    SizeReport compat.h5 $1 after
+    Census compat.h5 $1
+    ReadAll read_filter ""
+    rm -f read_filter_*.out
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run compound conversion test ####
+# tests/t_compound.c adds a large dset1 compound dataset to compat.h5,
+# keeping the format v1.6 can read.  read_compound_compat.c, built with
+# every library version, reads it into memory types that need different
+# compound conversions, checks the values and times the reads.
+Run_compound_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_compound_compat.c read_compound
+    ./gen_compat.out
+    SizeReport compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    ./a.out
+    SizeReport compat.h5 $1 after
+    Census compat.h5 $1
+    ReadAll read_compound ""
+    rm -f read_compound_*.out
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run byte order conversion test ####
+# gen_endian_compat.c, built with v1.6, creates endian_compat.h5 with
+# little- and big-endian integer and floating-point datasets of each width.
+# read_endian_compat.c, built with every library version, reads them into
+# native types, checks the values and times the conversions.  The writer
+# under test is not involved, so the lane runs once, before the loop over
+# writers, and its results are tagged with the v1.6 release.
+Run_endian_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_endian_compat.c read_endian
+    ./gen_endian_compat.out
+    Census endian_compat.h5 $1
+    ReadAll read_endian ""
+    rm -f read_endian_*.out endian_compat.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run variable-length test ####
+# gen_vlen_compat.c, built with v1.6, creates vlen_compat.h5 with
+# variable-length strings, an attribute of them and variable-length
+# sequences of integers, and tests/t_vlen.c adds the same objects with the
+# writer under test.  read_vlen_compat.c, built with every library version,
+# checks both sets and times reading and reclaiming them, with the heap
+# memory each read needs.
+Run_vlen_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_vlen_compat.c read_vlen
+    ./gen_vlen_compat.out
+    SizeReport vlen_compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    ./a.out
+    SizeReport vlen_compat.h5 $1 after
+    Census vlen_compat.h5 $1
+    ReadAll read_vlen ""
+    rm -f read_vlen_*.out vlen_compat.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run virtual dataset test ####
+# gen_vds_compat.c, built with v1.6, creates the source files and an empty
+# vds_compat.h5, and tests/t_vds.c adds virtual datasets over them, one
+# with a mapping per source file and one with a printf-style mapping.  A
+# v1.8 writer cannot create virtual datasets, so the expected output is
+# t_vds1 for $h5cc18 and t_vds2 for the newer versions.
+# read_vds_compat.c, built with every library version, times opening and
+# reading them; the versions before v1.10 only show that the open fails.
+Run_vds_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_vds_compat.c read_vds
+    ./gen_vds_compat.out
+    SizeReport vds_compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    ./a.out
+    SizeReport vds_compat.h5 $1 after
+    Census vds_compat.h5 $1
+    ReadAll read_vds ""
+    rm -f read_vds_*.out vds_compat.h5 vds_src_*.h5
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run file locking test ####
+# tests/t_lock.c holds compat.h5 open for writing while read_lock_compat.c,
+# built with every library version, forks concurrent readers against it.
+# All of the readers run at the same time and log to their own files, which
+# are collated into errors.log in the usual order afterwards.  The test is
+# run once with file locking and once with HDF5_USE_FILE_LOCKING=FALSE.
+# errors.log records whether the readers' first opens were refused: with
+# locking, v1.10 and newer readers are refused by a v1.10 or newer writer,
+# while v1.8 takes no lock.  The expected output is t_lock1 for $h5cc18 and
+# t_lock2 for the newer versions.
+Run_lock_Test()
+{
+    Test=$1".c"
+
+    echo
+    echo "#################  $1  #################"
+    $CC -o t_lock.out tests/$Test
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$Test with $CC"
+        exit 1
+    fi
+    BuildReaders read_lock_compat.c read_lock
+
+    for Locking in TRUE FALSE; do
+        if [ "$Locking" = "TRUE" ]; then
+            LockOpt=""
+        else
+            LockOpt="nolock"
+        fi
+
+        ./gen_compat.out
+        rm -f lock_ready
+        HDF5_USE_FILE_LOCKING=$Locking ./t_lock.out &
+        if ! WaitReady lock_ready $!
+        then
+            rm -f t_lock.out read_lock_*.out
+            exit 1
+        fi
+
+        for V in 16 18 110 112 114 dev; do
+            rm -f lock_$V.log
+            HDF5_USE_FILE_LOCKING=$Locking ./read_lock_$V.out lock_$V.log $LockOpt &
+        done
+        wait
+
+        for V in 16:v1.6 18:v1.8 110:v1.10 112:v1.12 114:v1.14 dev:vdev; do
+            if [ -s errors.log ]; then
+                echo >> errors.log
+                echo >> errors.log
+            fi
+            echo "========= Reading with ${V#*:}, HDF5_USE_FILE_LOCKING=$Locking =========" >> errors.log
+            echo >> errors.log
+            if [ -f lock_${V%%:*}.log ]; then
+                cat lock_${V%%:*}.log >> errors.log
+                rm lock_${V%%:*}.log
+            else
+                echo "messed up compiling read_lock_compat.c with ${V#*:}"
+            fi
+        done
+    done
+    rm -f lock_ready t_lock.out read_lock_*.out
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run SWMR test ####
+# tests/t_swmr.c creates swmr_compat.h5 and appends records to it in SWMR
+# mode while read_swmr_compat.c, built with every library version, is
+# started once per version at the same time.  The v1.10 and newer readers
+# poll with H5Drefresh() until they have seen every record; v1.6 and v1.8
+# must fail to open the file.  A v1.8 writer cannot use SWMR and creates no
+# file, so the expected output is t_swmr1 for $h5cc18 and t_swmr2 for the
+# newer versions.
+Run_swmr_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    $CC $BenchOpts -o t_swmr.out tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    BuildReaders read_swmr_compat.c read_swmr
+
+    rm -f swmr_ready swmr_compat.h5
+    ./t_swmr.out &
+    if ! WaitReady swmr_ready $!
+    then
+        rm -f t_swmr.out read_swmr_*.out swmr_compat.h5
+        exit 1
+    fi
+
+    for V in 16 18 110 112 114 dev; do
+        rm -f swmr_$V.log
+        ./read_swmr_$V.out swmr_$V.log 2>/dev/null &
+    done
+    wait
+
+    for V in 16:v1.6 18:v1.8 110:v1.10 112:v1.12 114:v1.14 dev:vdev; do
+        if [ -s errors.log ]; then
+            echo >> errors.log
+            echo >> errors.log
+        fi
+        echo "========= Reading with ${V#*:} =========" >> errors.log
+        echo >> errors.log
+        if [ -f swmr_${V%%:*}.log ]; then
+            cat swmr_${V%%:*}.log >> errors.log
+            rm swmr_${V%%:*}.log
+        else
+            echo "messed up compiling read_swmr_compat.c with ${V#*:}"
+        fi
+    done
+    rm -f swmr_ready swmr_compat.h5 t_swmr.out read_swmr_*.out
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run paged aggregation test ####
+# tests/t_paged.c creates the same file of small datasets with the default
+# file space strategy and with paged aggregation at three page sizes.
+# read_paged_compat.c, built with every library version, reads each file,
+# and the paged ones again with a page buffer from v1.10.1 on.  Writers
+# before v1.10.1 only create the default file, so the expected output is
+# t_paged1 for $h5cc18 and t_paged2 for the newer versions.
+Run_paged_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_paged_compat.c read_paged
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f paged_*.h5
+    ./a.out
+    if [ -f paged_64k.h5 ]; then
+        Census paged_64k.h5 $1
+    fi
+    ReadAll read_paged ""
+    rm -f read_paged_*.out paged_*.h5
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run metadata cache image test ####
+# tests/t_mdc_image.c creates the same many-object file in the v1.8 format
+# twice, once closed with a metadata cache image.  read_mdc_image_compat.c,
+# built with every library version, times opening each read-only and
+# visiting every object.  v1.6 cannot open either file and v1.8 cannot open
+# the one with the image.  Writers before v1.10.1 create no image, so the
+# expected output is t_mdc_image1 for $h5cc18 and t_mdc_image2 for the
+# newer versions.
+Run_mdc_image_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_mdc_image_compat.c read_mdc_image
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f mdci_*.h5
+    ./a.out
+    if [ -f mdci_image.h5 ]; then
+        Census mdci_image.h5 $1
+    fi
+    ReadAll read_mdc_image ""
+    rm -f read_mdc_image_*.out mdci_*.h5
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run free-space churn test ####
+# tests/t_fs_churn.c creates a file that does not keep its free space when
+# closed and, from v1.10.1 on, one that does.  churn_fs_compat.c, built
+# with every library version, deletes and recreates every object in both,
+# each version in turn, twice over; then each version reads them.  File
+# growth and open times go to the timing results.  v1.6 and v1.8 cannot
+# open the file that keeps its free space, and a v1.8 writer creates none,
+# so the expected output is t_fs_churn1 for $h5cc18 and t_fs_churn2 for
+# the newer versions.
+Run_fs_churn_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders churn_fs_compat.c churn_fs
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f fs_*.h5
+    ./a.out
+    for File in fs_nopersist.h5 fs_persist.h5; do
+        SizeReport $File $1 before
+    done
+    for Round in 1 2; do
+        ReadAll churn_fs " (churn, round $Round)" churn $Round
+    done
+    for File in fs_nopersist.h5 fs_persist.h5; do
+        SizeReport $File $1 after
+    done
+    if [ -f fs_persist.h5 ]; then
+        Census fs_persist.h5 $1
+    fi
+    ReadAll churn_fs "" read
+    rm -f churn_fs_*.out fs_*.h5
+
+    SaveTiming $1
+    if [ "$CC" = "$h5cc18" ]; then
+        CheckErrors $11
+    else
+        CheckErrors $12
+    fi
+    rm errors.log
+}
+
+
+#### Run shared object header message test ####
+# tests/t_sohm.c creates the same file of many small, uniform datasets
+# without shared object header messages, with one index for the datatype,
+# dataspace and fill value messages, and with an index for each.
+# read_sohm_compat.c, built with every library version, opens and checks
+# every dataset, timing each open and working out the metadata bytes that
+# sharing saves.  v1.6 can only open the file without sharing.
+Run_sohm_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_sohm_compat.c read_sohm
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f sohm_*.h5
+    ./a.out
+    for File in sohm_none.h5 sohm_one.h5 sohm_three.h5; do
+        SizeReport $File $1 after
+    done
+    Census sohm_one.h5 $1
+    ReadAll read_sohm ""
+    rm -f read_sohm_*.out sohm_*.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run link storage test ####
+# tests/t_links.c creates groups of 10 up to LINKS_MAX links as symbol
+# tables and, with a creation order index, as link messages in
+# links_v16.h5, and as link messages without the index in links_v18.h5;
+# past LINKS_MAX_COMPACT links the link messages switch to dense storage.
+# read_links_compat.c, built with every library version, times opening
+# each group, looking up links and iterating in name and creation order.
+# v1.6 can only open the symbol table groups.
+Run_links_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_links_compat.c read_links
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f links_*.h5
+    ./a.out
+    Census links_v16.h5 $1
+    ReadAll read_links ""
+    rm -f read_links_*.out links_*.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run attribute storage test ####
+# tests/t_attrs.c creates datasets with 1000 and 10000 attributes in the
+# object header, in the default format, and datasets with 1000 up to
+# ATTR_MAX attributes under three attribute phase change settings in the
+# v1.8 format, where most of them go to dense storage.  The default-format
+# file also gets phase change datasets of up to 10000 attributes that
+# track creation order, which gives them v1.8 object headers.
+# read_attrs_compat.c, built with every library version, times opening
+# each dataset, looking up attributes by name and iterating over them.
+# v1.6 can only open the datasets without creation order in attr_v16.h5.
+Run_attrs_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_attrs_compat.c read_attrs
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f attr_*.h5
+    ./a.out
+    Census attr_v16.h5 $1
+    ReadAll read_attrs ""
+    rm -f read_attrs_*.out attr_*.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run object header stress test ####
+# tests/t_ohdr.c creates datasets with attributes kept in v1 object
+# headers in ohdr_v16.h5 and in v2 object headers in ohdr_v18.h5.
+# ohdr_stress_compat.c, built with every library version, rewrites,
+# resizes, deletes and re-adds every attribute over and over, each version
+# in turn, twice over; then each version reads them.  The object header
+# chunks and free bytes left behind go to the timing results with the
+# read times.  v1.6 cannot open ohdr_v18.h5.
+Run_ohdr_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders ohdr_stress_compat.c ohdr_stress
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f ohdr_*.h5
+    ./a.out
+    for File in ohdr_v16.h5 ohdr_v18.h5; do
+        SizeReport $File $1 before
+    done
+    for Round in 1 2; do
+        ReadAll ohdr_stress " (stress, round $Round)" stress $Round
+    done
+    for File in ohdr_v16.h5 ohdr_v18.h5; do
+        SizeReport $File $1 after
+    done
+    Census ohdr_v18.h5 $1
+    ReadAll ohdr_stress "" read
+    rm -f ohdr_stress_*.out ohdr_*.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run fill value and allocation time test ####
+# tests/t_fill.c creates a contiguous and a chunked dataset with each
+# space allocation time and fill value write time, one per file, and then
+# writes the first part of each.  read_fill_compat.c, built with every
+# library version, reads them whole; the unwritten part must read as the
+# fill value unless the fill time is never, when what it reads as only
+# goes to the timing results with the create and first write times.
+Run_fill_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_fill_compat.c read_fill
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f fill_*.h5
+    ./a.out
+    Census fill_chunk_incr_ifset.h5 $1
+    ReadAll read_fill ""
+    rm -f read_fill_*.out fill_*.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run external link test ####
+# tests/t_elink.c creates ELINK_NFILES small files, each with a few
+# datasets, and adds a group to compat.h5 holding an external link to
+# every one of those datasets.  read_elink_compat.c, built with every
+# library version, follows all the links, moving to another file at each,
+# and checks the data; from v1.8.7 on it does so a second time with an
+# external link file cache and both traversal rates go to the timing
+# results.  v1.6 cannot open the group of links.
+Run_elink_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_elink_compat.c read_elink
+    ./gen_compat.out
+    SizeReport compat.h5 $1 before
+    $CC $BenchOpts tests/$1.c
+    if [ $? -ne 0 ]
+    then
+        echo "messed up compiling test/$1.c with $CC"
+        exit 1
+    fi
+    rm -f elink_*.h5
+    ./a.out
+    SizeReport compat.h5 $1 after
+    Census compat.h5 $1
+    ReadAll read_elink ""
+    rm -f read_elink_*.out elink_*.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
+#### Run raw data test ####
+# read_raw_compat.c checks contiguous data straight from the file with
+# mmap(), using the offset each library reports.  dset2 in compat.h5 is
+# checked after the tests that rewrite it; a baseline run beforehand
+# records its offset so that moved data shows up in the timing results,
+# under the name of the test that moved it.
+# The large dataset in raw_compat.h5 is checked last.
+Run_raw_Test()
+{
+    echo
+    echo "#################  $1  #################"
+    BuildReaders read_raw_compat.c read_raw
+    rm -f raw_baseline.txt
+
+    for Mod in t_newdata t_latest_mod_data; do
+        ./gen_compat.out
+        SizeReport compat.h5 $Mod before
+        ./read_raw_16.out compat.h5 /g4/dset2 baseline
+        $CC tests/$Mod.c
+        if [ $? -ne 0 ]
+        then
+            echo "messed up compiling test/$Mod.c with $CC"
+            exit 1
+        fi
+        ./a.out
+        SizeReport compat.h5 $Mod after
+        ReadAll read_raw " (after $Mod)" compat.h5 /g4/dset2 $Mod
+        rm -f raw_baseline.txt
+    done
+
+    ./gen_raw_compat.out
+    ReadAll read_raw " (raw_compat.h5)" raw_compat.h5 /raw raw_compat
+    rm -f read_raw_*.out raw_compat.h5
+
+    SaveTiming $1
+    CheckErrors $1
+    rm errors.log
+}
+
+
 
 ##################  MAIN  ##################
 
@@ -439,12 +1324,37 @@ then
     fi
 fi 
 
+# Timing results from the tests are collected here
+TimingDir="timing"
+
+# Format census of the modified test files, see Census()
+CensusDir="census"
+$NativeCC -o h5census.out h5census.c || echo "messed up compiling h5census.c"
+
+# Byte order test, once: only v1.6 writes its file
+CCTAG=v`$h5cc16 -showconfig | sed -n 's/^ *HDF5 Version: *//p'`
+$h5cc16 $BenchOpts -o gen_endian_compat.out gen_endian_compat.c
+if ( Run_endian_Test t_endian ); then
+    ENDIAN_EXIT=0
+else
+    ENDIAN_EXIT=2
+fi
+rm -f gen_endian_compat.out
+
 CompVERSIONS="$h5cc18 $h5cc110 $h5cc112 $h5ccdev"
 for CC in $CompVERSIONS; do
 
+# Release of the writing library, used to name the timing results
+CCTAG=v`$CC -showconfig | sed -n 's/^ *HDF5 Version: *//p'`
+
 # Compile gen_compat.c with v1.6
 $h5cc16 -o gen_compat.out gen_compat.c
 $h5cc16 -o gen_ref_compat.out gen_ref_compat.c
+$h5cc18 $BenchOpts -o gen_hyper_compat.out gen_hyper_compat.c
+$h5cc16 $BenchOpts -o gen_raw_compat.out gen_raw_compat.c
+$h5cc16 $BenchOpts -o gen_vlen_compat.out gen_vlen_compat.c
+$h5cc16 $BenchOpts -o gen_vds_compat.out gen_vds_compat.c
+$CC -o size_compat.out size_compat.c
 echo "Compiling tests with $CC"
 
 # Run tests
@@ -461,7 +1371,26 @@ then
         RunTest t_latest_mod_attr &&\
         RunTest t_latest_more_groups &&\
         RunTest t_index_link &&\
-        Run_ref_compat_Test t_ref); then
+        Run_ref_compat_Test t_ref &&\
+        Run_ref_scale_Test t_ref_scale &&\
+        Run_hyper_Test t_hyper &&\
+        Run_chunk_index_Test t_chunk_index &&\
+        Run_filter_Test t_filters &&\
+        Run_compound_Test t_compound &&\
+        Run_vlen_Test t_vlen &&\
+        Run_vds_Test t_vds &&\
+        Run_lock_Test t_lock &&\
+        Run_swmr_Test t_swmr &&\
+        Run_paged_Test t_paged &&\
+        Run_mdc_image_Test t_mdc_image &&\
+        Run_fs_churn_Test t_fs_churn &&\
+        Run_sohm_Test t_sohm &&\
+        Run_links_Test t_links &&\
+        Run_attrs_Test t_attrs &&\
+        Run_ohdr_Test t_ohdr &&\
+        Run_fill_Test t_fill &&\
+        Run_elink_Test t_elink &&\
+        Run_raw_Test t_raw); then
         EXIT_VALUE=0
     else
         EXIT_VALUE=2
@@ -474,6 +1403,11 @@ fi
 rm a.out
 rm gen_compat.out
 rm gen_ref_compat.out
+rm gen_hyper_compat.out
+rm gen_raw_compat.out
+rm gen_vlen_compat.out
+rm gen_vds_compat.out
+rm -f size_compat.out size_baseline*.txt
 rm *.o
 rm compat.h5
 rm ref_compat.h5
@@ -481,5 +1415,10 @@ echo
 
 done
 
+rm -f h5census.out
+
+if [ $ENDIAN_EXIT -ne 0 ]; then
+    EXIT_VALUE=$ENDIAN_EXIT
+fi
 exit $EXIT_VALUE
 
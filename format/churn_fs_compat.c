@@ -0,0 +1,278 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API churn_fs_compat.c
+ *
+ *  Modify or read the files tests/t_fs_churn.c creates, fs_nopersist.h5
+ *  and fs_persist.h5.  check_format.sh runs this once per library release
+ *  in turn, twice over, so that every release modifies files
+ *  the others have modified, and then once more per release to read them.
+ *
+ *  Usage:  a.out churn <round>
+ *              Open each file for writing and FSC_NCYCLES times delete and
+ *              recreate every dataset and its attributes, with the same
+ *              values.  Space freed while the file is open is reused;
+ *              whether space freed before it was opened can be depends
+ *              on the file keeping its free space.
+ *          a.out read
+ *              Open each file read-only and check every dataset and
+ *              attribute.
+ *
+ *  Either way each file is first opened read-only and closed, untimed, so
+ *  that fs_nopersist.h5, which always comes first, does not pay for
+ *  initializing the library in its timed open.
+ *
+ *  These go to TIMEPATH:
+ *
+ *      <file>_r<round>_open    H5Fopen() for writing, in ms
+ *      <file>_r<round>_churn   all the cycles, in ms
+ *      <file>_r<round>_growth  bytes the file grew by
+ *      <file>_open             H5Fopen() read-only, in ms
+ *      <file>_size             file size when read, in bytes
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The objects, as in tests/t_fs_churn.c */
+#ifndef FSC_NDSETS
+#define FSC_NDSETS      32
+#endif
+#define FSC_NELMTS      4096
+#define FSC_NATTRS      8
+#define FSC_ATTR_NELMTS 16
+
+/* Delete and recreate cycles per run */
+#ifndef FSC_NCYCLES
+#define FSC_NCYCLES     8
+#endif
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Return the size of file name, or -1 */
+static double
+file_size(const char *name)
+{
+    struct stat sb;
+
+    if(stat(name, &sb) < 0)
+        return -1.0;
+
+    return (double)sb.st_size;
+} /* file_size() */
+
+/* Delete dataset n and its attributes, then create them again */
+int
+recreate(hid_t fid, int n)
+{
+    hid_t sid, asid, did, aid;
+    hsize_t dims[1];
+    int buf[FSC_NELMTS], abuf[FSC_ATTR_NELMTS];
+    char dname[32], aname[32];
+    int k, i, ret = 0;
+
+    sprintf(dname, "/d%d", n);
+    if((did = H5Dopen(fid, dname)) < 0)
+        return -1;
+    for(k = 0; k < FSC_NATTRS; k++) {
+        sprintf(aname, "a%d", k);
+        if(H5Adelete(did, aname) < 0)
+            ret = -1;
+    }
+    H5Dclose(did);
+    if(ret < 0 || H5Gunlink(fid, dname) < 0)
+        return -1;
+
+    dims[0] = FSC_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    dims[0] = FSC_ATTR_NELMTS;
+    asid = H5Screate_simple(1, dims, NULL);
+    if((did = H5Dcreate(fid, dname, H5T_NATIVE_INT, sid, H5P_DEFAULT)) < 0)
+        ret = -1;
+    else {
+        for(i = 0; i < FSC_NELMTS; i++)
+            buf[i] = n * FSC_NELMTS + i;
+        if(H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+            ret = -1;
+        for(k = 0; k < FSC_NATTRS && ret == 0; k++) {
+            for(i = 0; i < FSC_ATTR_NELMTS; i++)
+                abuf[i] = n + k + i;
+            sprintf(aname, "a%d", k);
+            if((aid = H5Acreate(did, aname, H5T_NATIVE_INT, asid, H5P_DEFAULT)) < 0)
+                ret = -1;
+            else {
+                if(H5Awrite(aid, H5T_NATIVE_INT, abuf) < 0)
+                    ret = -1;
+                H5Aclose(aid);
+            }
+        }
+        H5Dclose(did);
+    }
+    H5Sclose(asid);
+    H5Sclose(sid);
+
+    return ret;
+} /* recreate() */
+
+/* Open file name for writing and run FSC_NCYCLES delete and recreate
+ * cycles over every dataset */
+int
+churn_file(const char *name, const char *round)
+{
+    hid_t fid;
+    char what[32];
+    double size0, t0, t;
+    int c, n, ret = 0;
+
+    size0 = file_size(name);
+    t0 = compat_time_now();
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDWR, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+    t = compat_time_now();
+    sprintf(what, "r%s_open", round);
+    compat_timing_file("t_fs_churn", name, what, (t - t0) * 1000.0, "ms");
+
+    for(c = 0; c < FSC_NCYCLES && ret == 0; c++)
+        for(n = 0; n < FSC_NDSETS && ret == 0; n++)
+            ret = recreate(fid, n);
+    if(H5Fclose(fid) < 0)
+        ret = -1;
+
+    if(ret == 0) {
+        sprintf(what, "r%s_churn", round);
+        compat_timing_file("t_fs_churn", name, what, (compat_time_now() - t) * 1000.0, "ms");
+        sprintf(what, "r%s_growth", round);
+        compat_timing_file("t_fs_churn", name, what, file_size(name) - size0, "bytes");
+    }
+
+    return ret;
+} /* churn_file() */
+
+/* Open file name read-only and check every dataset and attribute */
+int
+read_file(const char *name)
+{
+    hid_t fid, did, aid;
+    int buf[FSC_NELMTS], abuf[FSC_ATTR_NELMTS];
+    char dname[32], aname[32];
+    double t0;
+    int n, k, i, ret = 0;
+
+    t0 = compat_time_now();
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+    compat_timing_file("t_fs_churn", name, "open", (compat_time_now() - t0) * 1000.0, "ms");
+
+    for(n = 0; n < FSC_NDSETS && ret == 0; n++) {
+        sprintf(dname, "/d%d", n);
+        if((did = H5Dopen(fid, dname)) < 0) {
+            ret = -1;
+            break;
+        }
+        if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+            ret = -1;
+        for(i = 0; i < FSC_NELMTS && ret == 0; i++)
+            if(buf[i] != n * FSC_NELMTS + i)
+                ret = -1;
+        for(k = 0; k < FSC_NATTRS && ret == 0; k++) {
+            sprintf(aname, "a%d", k);
+            if((aid = H5Aopen_name(did, aname)) < 0) {
+                ret = -1;
+                break;
+            }
+            if(H5Aread(aid, H5T_NATIVE_INT, abuf) < 0)
+                ret = -1;
+            H5Aclose(aid);
+            for(i = 0; i < FSC_ATTR_NELMTS && ret == 0; i++)
+                if(abuf[i] != n + k + i)
+                    ret = -1;
+        }
+        H5Dclose(did);
+    }
+    H5Fclose(fid);
+
+    if(ret == 0)
+        compat_timing_file("t_fs_churn", name, "size", file_size(name), "bytes");
+
+    return ret;
+} /* read_file() */
+
+/* Initialize the library and open and close each file once, untimed */
+void
+warm_up(const char *names[], int nnames)
+{
+    hid_t fid;
+    int f;
+
+    H5open();
+    for(f = 0; f < nnames; f++) {
+        H5E_BEGIN_TRY {
+            fid = H5Fopen(names[f], H5F_ACC_RDONLY, H5P_DEFAULT);
+        } H5E_END_TRY;
+        if(fid >= 0)
+            H5Fclose(fid);
+    }
+} /* warm_up() */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    const char *names[2] = {"fs_nopersist.h5", "fs_persist.h5"};
+    int f;
+
+    if(argc < 2 || (strcmp(argv[1], "read") && (strcmp(argv[1], "churn") || argc < 3))) {
+        fprintf(stderr, "usage: %s churn <round> | read\n", argv[0]);
+        return 1;
+    }
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    warm_up(names, 2);
+
+    for(f = 0; f < 2; f++) {
+        if(!strcmp(argv[1], "churn"))
+            check(churn_file(names[f], argv[2]), "churn", names[f], NULL, fp);
+        else
+            check(read_file(names[f]), "read", names[f], NULL, fp);
+    }
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
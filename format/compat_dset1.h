@@ -0,0 +1,229 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  The dset1 fixture: a compound type whose members are 2x2x2x2 arrays,
+ *  and the values gen_compat.c writes with it.  Every program that creates
+ *  or checks dset1 uses this header so that they cannot drift apart.
+ *
+ *  For element j of a dataset of N elements, with i0 the fastest-changing
+ *  array index:
+ *      a[i3][i2][i1][i0] = i0 + j
+ *      b[i3][i2][i1][i0] = i0 + j
+ *      c[i3][i2][i1][i0] = i0 + j + N
+ *
+ *  dset1 holds DSET1_NELMTS elements, 6 unless the programs are compiled
+ *  with e.g. -DDSET1_NELMTS=1000000.  Readers take the count from the
+ *  dataspace, so they need not be compiled with the same value.  Data is
+ *  written and read DSET1_SLAB elements at a time.
+ *
+ *  The routines compile with every library release, v1.6 included, and
+ *  with or without H5_USE_16_API.
+ */
+
+#ifndef COMPAT_DSET1_H
+#define COMPAT_DSET1_H
+
+#include <stdlib.h>
+#include "hdf5.h"
+
+/* Elements in dset1 */
+#ifndef DSET1_NELMTS
+#define DSET1_NELMTS    6
+#endif
+
+/* Largest chunk of dset1, in elements */
+#define DSET1_MAX_CHUNK 8192
+
+/* Elements written or read per H5Dwrite()/H5Dread() call */
+#define DSET1_SLAB      65536
+
+/* Values in each array member */
+#define DSET1_NVALS     16
+
+typedef struct { /* compound type has members with rank > 1 */
+  int a[2][2][2][2]; /* arrays are 2x2x2x2    */
+  double b[2][2][2][2];
+  double c[2][2][2][2];
+} dset1_t;
+
+/* i0 for each value of an array member, in memory order */
+static const int dset1_i0[DSET1_NVALS] = {0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1};
+
+/* Create an array datatype; H5Tarray_create() lost its perm argument in v1.8 */
+static inline hid_t
+dset1_array_create(hid_t base_id, int rank, const hsize_t dims[])
+{
+#if H5_VERS_MAJOR == 1 && H5_VERS_MINOR < 8
+    return H5Tarray_create(base_id, rank, dims, NULL);
+#else
+    return H5Tarray_create2(base_id, (unsigned)rank, dims);
+#endif
+} /* dset1_array_create() */
+
+/* Create the native compound datatype of dset1 */
+static inline hid_t
+dset1_create_type(void)
+{
+    hid_t tid;          /* datatype ID */
+    hid_t array_dt;
+    hsize_t dim[4];
+
+    dim[0] = dim[1] = dim[2] = dim[3] = 2;
+    if((tid = H5Tcreate(H5T_COMPOUND, sizeof(dset1_t))) < 0)
+        return -1;
+
+    array_dt = dset1_array_create(H5T_NATIVE_INT, 4, dim);
+    H5Tinsert(tid, "a_array", HOFFSET(dset1_t, a), array_dt);
+    H5Tclose(array_dt);
+
+    array_dt = dset1_array_create(H5T_NATIVE_DOUBLE, 4, dim);
+    H5Tinsert(tid, "b_array", HOFFSET(dset1_t, b), array_dt);
+    H5Tclose(array_dt);
+
+    array_dt = dset1_array_create(H5T_NATIVE_DOUBLE, 4, dim);
+    H5Tinsert(tid, "c_array", HOFFSET(dset1_t, c), array_dt);
+    H5Tclose(array_dt);
+
+    return tid;
+} /* dset1_create_type() */
+
+/* Chunk size for a dset1 of nelmts elements: one chunk while it is small */
+static inline hsize_t
+dset1_chunk_size(hsize_t nelmts)
+{
+    return nelmts < DSET1_MAX_CHUNK ? nelmts : DSET1_MAX_CHUNK;
+} /* dset1_chunk_size() */
+
+/* Fill count elements starting at element first of a total-element dset1 */
+static inline void
+dset1_fill(dset1_t *buf, hsize_t first, size_t count, hsize_t total)
+{
+    size_t k;
+    int n;
+
+    for(k = 0; k < count; k++) {
+        int *a = &buf[k].a[0][0][0][0];
+        double *b = &buf[k].b[0][0][0][0];
+        double *c = &buf[k].c[0][0][0][0];
+        double j = (double)(first + k);
+        double cj = (double)(first + k + total);
+
+        for(n = 0; n < DSET1_NVALS; n++) {
+            a[n] = dset1_i0[n] + (int)(first + k);
+            b[n] = (double)dset1_i0[n] + j;
+            c[n] = (double)dset1_i0[n] + cj;
+        }
+    }
+} /* dset1_fill() */
+
+/* Compare count elements with what dset1_fill() writes there */
+static inline int
+dset1_verify(const dset1_t *buf, hsize_t first, size_t count, hsize_t total)
+{
+    size_t k;
+    int n, bad = 0;
+
+    for(k = 0; k < count && !bad; k++) {
+        const int *a = &buf[k].a[0][0][0][0];
+        const double *b = &buf[k].b[0][0][0][0];
+        const double *c = &buf[k].c[0][0][0][0];
+        double j = (double)(first + k);
+        double cj = (double)(first + k + total);
+
+        for(n = 0; n < DSET1_NVALS; n++)
+            bad |= (a[n] != dset1_i0[n] + (int)(first + k))
+                 | (b[n] != (double)dset1_i0[n] + j)
+                 | (c[n] != (double)dset1_i0[n] + cj);
+    }
+
+    return bad ? -1 : 0;
+} /* dset1_verify() */
+
+/* Write the fixture values to all nelmts elements of dataset did */
+static inline int
+dset1_write(hid_t did, hid_t mem_tid, hsize_t nelmts)
+{
+    dset1_t *buf;
+    hid_t sid, mid;
+    hsize_t start, count;
+    int ret = 0;
+
+    count = nelmts < DSET1_SLAB ? nelmts : DSET1_SLAB;
+    if((buf = (dset1_t *)malloc(sizeof(dset1_t) * (size_t)(count ? count : 1))) == NULL)
+        return -1;
+
+    /* One call covers a small dataset, as it always did */
+    if(nelmts <= DSET1_SLAB) {
+        dset1_fill(buf, 0, (size_t)nelmts, nelmts);
+        if(H5Dwrite(did, mem_tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+            ret = -1;
+        free(buf);
+        return ret;
+    }
+
+    sid = H5Dget_space(did);
+    for(start = 0; start < nelmts && ret == 0; start += count) {
+        count = nelmts - start < DSET1_SLAB ? nelmts - start : DSET1_SLAB;
+        dset1_fill(buf, start, (size_t)count, nelmts);
+        mid = H5Screate_simple(1, &count, NULL);
+        H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, NULL, &count, NULL);
+        if(H5Dwrite(did, mem_tid, mid, sid, H5P_DEFAULT, buf) < 0)
+            ret = -1;
+        H5Sclose(mid);
+    }
+    H5Sclose(sid);
+    free(buf);
+
+    return ret;
+} /* dset1_write() */
+
+/* Read all of dataset did and verify it; return the element count, or -1 */
+static inline hssize_t
+dset1_read_verify(hid_t did, hid_t mem_tid)
+{
+    dset1_t *buf;
+    hid_t sid, mid;
+    hsize_t nelmts, start, count;
+    hssize_t ret;
+
+    if((sid = H5Dget_space(did)) < 0)
+        return -1;
+    if(H5Sget_simple_extent_ndims(sid) != 1 || (ret = H5Sget_simple_extent_npoints(sid)) < 0) {
+        H5Sclose(sid);
+        return -1;
+    }
+    nelmts = (hsize_t)ret;
+    count = nelmts < DSET1_SLAB ? nelmts : DSET1_SLAB;
+    if((buf = (dset1_t *)malloc(sizeof(dset1_t) * (size_t)(count ? count : 1))) == NULL) {
+        H5Sclose(sid);
+        return -1;
+    }
+
+    for(start = 0; start < nelmts && ret >= 0; start += count) {
+        count = nelmts - start < DSET1_SLAB ? nelmts - start : DSET1_SLAB;
+        mid = H5Screate_simple(1, &count, NULL);
+        H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, NULL, &count, NULL);
+        if(H5Dread(did, mem_tid, mid, sid, H5P_DEFAULT, buf) < 0
+                || dset1_verify(buf, start, (size_t)count, nelmts) < 0)
+            ret = -1;
+        H5Sclose(mid);
+    }
+    H5Sclose(sid);
+    free(buf);
+
+    return ret;
+} /* dset1_read_verify() */
+
+#endif /* COMPAT_DSET1_H */
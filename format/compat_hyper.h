@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  The scaled region references of the hyperslab test: gen_hyper_compat.c
+ *  and tests/t_hyper.c store each region reference they write to
+ *  hyper_compat.h5 HYPER_NREFS more times, as <dataset>_scale, so that
+ *  read_hyper_compat.c can time decoding them.
+ *
+ *  The routines need v1.8 or later (H5Dcreate2).
+ */
+
+#ifndef COMPAT_HYPER_H
+#define COMPAT_HYPER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "hdf5.h"
+#include "compat_timing.h"
+
+/* The dataset the references point to */
+#define HYPER_DSET          "dset"
+
+/* References in each <dataset>_scale dataset */
+#ifndef HYPER_NREFS
+#define HYPER_NREFS         16384
+#endif
+
+/* Store HYPER_NREFS references to the selection in sid as the dataset
+ * <name>_scale, and time creating and writing them */
+static inline int
+hyper_write_scale(hid_t fid, const char *name, hid_t sid)
+{
+    hid_t ref_sid = -1;     /* Dataspace ID */
+    hid_t ref_did = -1;     /* Dataset ID */
+    hsize_t ref_dims[1];    /* Dimension size */
+    hdset_reg_ref_t *ref_wbuf;  /* Buffer for the references */
+    char scale_name[64];
+    char metric[64];
+    double t;
+    int k, ret = 0;
+
+    if((ref_wbuf = calloc(sizeof(hdset_reg_ref_t), (size_t)HYPER_NREFS)) == NULL)
+        return -1;
+
+    /* Each reference stores its selection in the global heap */
+    t = compat_time_now();
+    for(k = 0; k < HYPER_NREFS && ret >= 0; k++)
+        ret = H5Rcreate(&ref_wbuf[k], fid, HYPER_DSET, H5R_DATASET_REGION, sid);
+    t = compat_time_now() - t;
+
+    if(ret >= 0) {
+        sprintf(metric, "%s_create", name);
+        compat_timing("t_hyper", metric, t > 0.0 ? HYPER_NREFS / t : 0.0, "refs/s");
+
+        sprintf(scale_name, "%s_scale", name);
+        ref_dims[0] = HYPER_NREFS;
+        ref_sid = H5Screate_simple(1, ref_dims, NULL);
+        t = compat_time_now();
+        if((ref_did = H5Dcreate2(fid, scale_name, H5T_STD_REF_DSETREG, ref_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+            ret = -1;
+        else {
+            ret = H5Dwrite(ref_did, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf);
+            H5Dclose(ref_did);
+        }
+        t = compat_time_now() - t;
+        H5Sclose(ref_sid);
+
+        if(ret >= 0) {
+            sprintf(metric, "%s_write", name);
+            compat_timing("t_hyper", metric, t > 0.0 ? HYPER_NREFS / t : 0.0, "refs/s");
+        }
+    }
+
+    free(ref_wbuf);
+
+    return ret < 0 ? -1 : 0;
+} /* hyper_write_scale() */
+
+#endif /* COMPAT_HYPER_H */
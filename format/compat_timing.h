@@ -0,0 +1,100 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  Timing helpers for the format tests that also measure performance.
+ *
+ *  Timings differ from run to run, so they must never go to errors.log,
+ *  which is compared byte for byte against tests/expected/.  They are
+ *  appended to TIMEPATH instead, one measurement per line:
+ *
+ *      <test> <library release> <metric> <value> <unit>
+ *
+ *  check_format.sh moves TIMEPATH into the timing/ directory after each
+ *  test.  This header only uses routines present in every library release,
+ *  v1.6 included.  The helpers are static inline so that files which use
+ *  only some of them still build cleanly with -Wall.
+ */
+
+#ifndef COMPAT_TIMING_H
+#define COMPAT_TIMING_H
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include "hdf5.h"
+
+/* The timing log file */
+#define TIMEPATH "./timing.log"
+
+/* Return the wall clock time in seconds */
+static inline double
+compat_time_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return((double)tv.tv_sec + (double)tv.tv_usec / 1000000.0);
+} /* compat_time_now() */
+
+/* Return the throughput in MB/s for nbytes moved in the given seconds */
+static inline double
+compat_mbps(double nbytes, double seconds)
+{
+    if(seconds <= 0.0)
+        return(0.0);
+
+    return(nbytes / (1024.0 * 1024.0) / seconds);
+} /* compat_mbps() */
+
+/* Append one measurement to TIMEPATH, tagged with the library release */
+static inline void
+compat_timing(const char *test, const char *metric, double value, const char *unit)
+{
+    FILE *tp;
+    unsigned major, minor, release;     /* Library release versions */
+
+    H5get_libversion(&major, &minor, &release);
+
+    if((tp = fopen(TIMEPATH, "a")) == NULL)
+        return;
+    fprintf(tp, "%s v%u.%u.%u %s %.6f %s\n", test, major, minor, release, metric, value, unit);
+    fclose(tp);
+} /* compat_timing() */
+
+/* Append one measurement of the test file name, as the metric
+ * <name>_<what> with any ".h5" left out of name */
+static inline void
+compat_timing_file(const char *test, const char *name, const char *what, double value, const char *unit)
+{
+    char metric[128];
+    size_t len = strlen(name);
+
+    if(len > 3 && !strcmp(name + len - 3, ".h5"))
+        len -= 3;
+    sprintf(metric, "%.*s_%.*s", (int)(len < 63 ? len : 63), name, 63, what);
+    compat_timing(test, metric, value, unit);
+} /* compat_timing_file() */
+
+/* qsort() comparator for doubles, for percentiles of measurements */
+static inline int
+compat_cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return(x < y ? -1 : x > y ? 1 : 0);
+} /* compat_cmp_double() */
+
+#endif /* COMPAT_TIMING_H */
@@ -0,0 +1,215 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  The variable-length fixture: what gen_vlen_compat.c and tests/t_vlen.c
+ *  write to each of their groups in vlen_compat.h5, and what
+ *  read_vlen_compat.c checks there.
+ *
+ *      strings     VLEN_NELMTS variable-length strings, string k holding
+ *                  VLEN_STR_LEN(k) characters VLEN_STR_CHAR(k, i)
+ *      sequences   VLEN_NELMTS variable-length sequences of int, sequence
+ *                  k holding VLEN_SEQ_LEN(k) values VLEN_SEQ_VALUE(k, i)
+ *      strings     (attribute of the group) the first VLEN_NATTR strings
+ *
+ *  The routines compile with every library release, v1.6 included, and
+ *  with or without H5_USE_16_API.
+ */
+
+#ifndef COMPAT_VLEN_H
+#define COMPAT_VLEN_H
+
+#include <stdlib.h>
+#include "hdf5.h"
+
+/* Elements in each dataset */
+#ifndef VLEN_NELMTS
+#define VLEN_NELMTS     65536
+#endif
+
+/* Strings in the attribute, which must stay within 64 KB of heap IDs */
+#define VLEN_NATTR      1024
+
+#define VLEN_STR_LEN(k)         (1 + (size_t)((k) % 64))
+#define VLEN_STR_CHAR(k, i)     ((char)('a' + ((k) + (i)) % 26))
+#define VLEN_SEQ_LEN(k)         ((size_t)((k) % 32))
+#define VLEN_SEQ_VALUE(k, i)    ((int)((k) + (i)))
+
+/* Create the variable-length string type */
+static inline hid_t
+vlen_str_type(void)
+{
+    hid_t tid;
+
+    tid = H5Tcopy(H5T_C_S1);
+    H5Tset_size(tid, H5T_VARIABLE);
+
+    return tid;
+} /* vlen_str_type() */
+
+/* Fill n strings; the characters go to one block, returned for free() */
+static inline char *
+vlen_str_fill(char **buf, size_t n)
+{
+    char *chars, *p;
+    size_t k, i;
+
+    if((chars = p = (char *)malloc(n * (VLEN_STR_LEN(63) + 1))) == NULL)
+        return NULL;
+    for(k = 0; k < n; k++) {
+        buf[k] = p;
+        for(i = 0; i < VLEN_STR_LEN(k); i++)
+            *p++ = VLEN_STR_CHAR(k, i);
+        *p++ = '\0';
+    }
+
+    return chars;
+} /* vlen_str_fill() */
+
+/* Fill n sequences; the values go to one block, returned for free() */
+static inline int *
+vlen_seq_fill(hvl_t *buf, size_t n)
+{
+    int *values, *p;
+    size_t k, i;
+
+    if((values = p = (int *)malloc(n * VLEN_SEQ_LEN(31) * sizeof(int) + 1)) == NULL)
+        return NULL;
+    for(k = 0; k < n; k++) {
+        buf[k].len = VLEN_SEQ_LEN(k);
+        buf[k].p = p;
+        for(i = 0; i < VLEN_SEQ_LEN(k); i++)
+            *p++ = VLEN_SEQ_VALUE(k, i);
+    }
+
+    return values;
+} /* vlen_seq_fill() */
+
+/* Compare n strings with what vlen_str_fill() writes */
+static inline int
+vlen_str_verify(char * const *buf, size_t n)
+{
+    size_t k, i;
+
+    for(k = 0; k < n; k++) {
+        if(buf[k] == NULL)
+            return -1;
+        for(i = 0; i < VLEN_STR_LEN(k); i++)
+            if(buf[k][i] != VLEN_STR_CHAR(k, i))
+                return -1;
+        if(buf[k][i] != '\0')
+            return -1;
+    }
+
+    return 0;
+} /* vlen_str_verify() */
+
+/* Compare n sequences with what vlen_seq_fill() writes */
+static inline int
+vlen_seq_verify(const hvl_t *buf, size_t n)
+{
+    size_t k, i;
+
+    for(k = 0; k < n; k++) {
+        if(buf[k].len != VLEN_SEQ_LEN(k))
+            return -1;
+        for(i = 0; i < buf[k].len; i++)
+            if(((const int *)buf[k].p)[i] != VLEN_SEQ_VALUE(k, i))
+                return -1;
+    }
+
+    return 0;
+} /* vlen_seq_verify() */
+
+/* Create a dataset; H5Dcreate() gained property lists in v1.8 */
+static inline hid_t
+vlen_dcreate(hid_t loc_id, const char *name, hid_t tid, hid_t sid)
+{
+#if H5_VERS_MAJOR == 1 && H5_VERS_MINOR < 8
+    return H5Dcreate(loc_id, name, tid, sid, H5P_DEFAULT);
+#else
+    return H5Dcreate2(loc_id, name, tid, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+#endif
+} /* vlen_dcreate() */
+
+/* Create an attribute; H5Acreate() gained one more property list in v1.8 */
+static inline hid_t
+vlen_acreate(hid_t loc_id, const char *name, hid_t tid, hid_t sid)
+{
+#if H5_VERS_MAJOR == 1 && H5_VERS_MINOR < 8
+    return H5Acreate(loc_id, name, tid, sid, H5P_DEFAULT);
+#else
+    return H5Acreate2(loc_id, name, tid, sid, H5P_DEFAULT, H5P_DEFAULT);
+#endif
+} /* vlen_acreate() */
+
+/* Write dataset or attribute "strings" of n elements to loc_id; the
+ * attribute if is_attr */
+static inline int
+vlen_write_strings(hid_t loc_id, hsize_t n, int is_attr)
+{
+    hid_t tid, sid, id;
+    char **strs;
+    char *chars = NULL;
+    int ret = -1;
+
+    if((strs = (char **)malloc(sizeof(char *) * (size_t)n)) != NULL
+            && (chars = vlen_str_fill(strs, (size_t)n)) != NULL) {
+        tid = vlen_str_type();
+        sid = H5Screate_simple(1, &n, NULL);
+        if(is_attr) {
+            id = vlen_acreate(loc_id, "strings", tid, sid);
+            ret = H5Awrite(id, tid, strs);
+            H5Aclose(id);
+        }
+        else {
+            id = vlen_dcreate(loc_id, "strings", tid, sid);
+            ret = H5Dwrite(id, tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, strs);
+            H5Dclose(id);
+        }
+        H5Sclose(sid);
+        H5Tclose(tid);
+    }
+    free(strs);
+    free(chars);
+
+    return ret < 0 ? -1 : 0;
+} /* vlen_write_strings() */
+
+/* Write dataset "sequences" of n elements to loc_id */
+static inline int
+vlen_write_sequences(hid_t loc_id, hsize_t n)
+{
+    hid_t tid, sid, did;
+    hvl_t *seqs;
+    int *values = NULL;
+    int ret = -1;
+
+    if((seqs = (hvl_t *)malloc(sizeof(hvl_t) * (size_t)n)) != NULL
+            && (values = vlen_seq_fill(seqs, (size_t)n)) != NULL) {
+        tid = H5Tvlen_create(H5T_NATIVE_INT);
+        sid = H5Screate_simple(1, &n, NULL);
+        did = vlen_dcreate(loc_id, "sequences", tid, sid);
+        ret = H5Dwrite(did, tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, seqs);
+        H5Dclose(did);
+        H5Sclose(sid);
+        H5Tclose(tid);
+    }
+    free(seqs);
+    free(values);
+
+    return ret < 0 ? -1 : 0;
+} /* vlen_write_sequences() */
+
+#endif /* COMPAT_VLEN_H */
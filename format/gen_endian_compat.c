@@ -0,0 +1,128 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API gen_endian_compat.c
+ *
+ *  Create endian_compat.h5 with one contiguous dataset of ENDIAN_NELMTS
+ *  elements for each of these file types:
+ *
+ *      i16le i16be     H5T_STD_I16LE, H5T_STD_I16BE
+ *      i32le i32be     H5T_STD_I32LE, H5T_STD_I32BE
+ *      i64le i64be     H5T_STD_I64LE, H5T_STD_I64BE
+ *      f32le f32be     H5T_IEEE_F32LE, H5T_IEEE_F32BE
+ *      f64le f64be     H5T_IEEE_F64LE, H5T_IEEE_F64BE
+ *
+ *  Each is written from the native type of the same width, so one of each
+ *  pair is converted on the way out, and read_endian_compat.c times the
+ *  conversion back.  Element k holds ENDIAN_INT(k) times the width's
+ *  scale for the integers, and ENDIAN_FLOAT(k) for the floating-point
+ *  types; every value is exact in its type.
+ *
+ *  ENDIAN_NELMTS defaults to 1M elements, 52 MB over all the datasets.
+ */
+
+#include "hdf5.h"
+#include <stdlib.h>
+#include "compat_timing.h"
+
+/* The test file */
+#define FILENAME    "endian_compat.h5"
+
+#ifndef ENDIAN_NELMTS
+#define ENDIAN_NELMTS   1048576
+#endif
+
+/* The values, as in read_endian_compat.c */
+#define ENDIAN_INT(k)   ((long long)((k) % 32749) - 16374)
+#define ENDIAN_FLOAT(k) ((double)ENDIAN_INT(k) / 8.0)
+#define ENDIAN_SCALE16  1LL
+#define ENDIAN_SCALE32  65537LL
+#define ENDIAN_SCALE64  (65537LL * 65537LL * 65537LL)
+
+/* Create dataset name with file type ftid and write buf to it from mtid */
+static void
+write_dset(hid_t fid, const char *name, hid_t ftid, hid_t mtid, const void *buf)
+{
+    hid_t sid;          /* Dataspace ID */
+    hid_t did;          /* Dataset ID */
+    hsize_t dims[1];    /* Dataset dimension size */
+    char metric[64];
+    double t;
+
+    dims[0] = ENDIAN_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+
+    t = compat_time_now();
+    did = H5Dcreate(fid, name, ftid, sid, H5P_DEFAULT);
+    H5Dwrite(did, mtid, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+    H5Dclose(did);
+    t = compat_time_now() - t;
+
+    sprintf(metric, "%s_write", name);
+    compat_timing("t_endian", metric, compat_mbps((double)ENDIAN_NELMTS * H5Tget_size(ftid), t), "MB/s");
+
+    H5Sclose(sid);
+} /* write_dset() */
+
+int main(void)
+{
+    hid_t fid;          /* File ID */
+    short *i16;
+    int *i32;
+    long long *i64;
+    float *f32;
+    double *f64;
+    hsize_t k;
+
+    i16 = (short *)malloc(sizeof(short) * ENDIAN_NELMTS);
+    i32 = (int *)malloc(sizeof(int) * ENDIAN_NELMTS);
+    i64 = (long long *)malloc(sizeof(long long) * ENDIAN_NELMTS);
+    f32 = (float *)malloc(sizeof(float) * ENDIAN_NELMTS);
+    f64 = (double *)malloc(sizeof(double) * ENDIAN_NELMTS);
+
+    for(k = 0; k < ENDIAN_NELMTS; k++) {
+        i16[k] = (short)(ENDIAN_INT(k) * ENDIAN_SCALE16);
+        i32[k] = (int)(ENDIAN_INT(k) * ENDIAN_SCALE32);
+        i64[k] = ENDIAN_INT(k) * ENDIAN_SCALE64;
+        f32[k] = (float)ENDIAN_FLOAT(k);
+        f64[k] = ENDIAN_FLOAT(k);
+    }
+
+    /* Create the test file */
+    fid = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+    write_dset(fid, "i16le", H5T_STD_I16LE, H5T_NATIVE_SHORT, i16);
+    write_dset(fid, "i16be", H5T_STD_I16BE, H5T_NATIVE_SHORT, i16);
+    write_dset(fid, "i32le", H5T_STD_I32LE, H5T_NATIVE_INT, i32);
+    write_dset(fid, "i32be", H5T_STD_I32BE, H5T_NATIVE_INT, i32);
+    write_dset(fid, "i64le", H5T_STD_I64LE, H5T_NATIVE_LLONG, i64);
+    write_dset(fid, "i64be", H5T_STD_I64BE, H5T_NATIVE_LLONG, i64);
+    write_dset(fid, "f32le", H5T_IEEE_F32LE, H5T_NATIVE_FLOAT, f32);
+    write_dset(fid, "f32be", H5T_IEEE_F32BE, H5T_NATIVE_FLOAT, f32);
+    write_dset(fid, "f64le", H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, f64);
+    write_dset(fid, "f64be", H5T_IEEE_F64BE, H5T_NATIVE_DOUBLE, f64);
+
+    /* Closing */
+    H5Fclose(fid);
+
+    free(i16);
+    free(i32);
+    free(i64);
+    free(f32);
+    free(f64);
+
+    return 0;
+} /* main() */
@@ -19,17 +19,23 @@
  *  Generate a test file with dataset region references for testing the
  *  hyperslab/point selection format change.
  *  See tests/t_hyper.c and read_hyper_compat.c.
+ *
+ *  Each reference is also stored HYPER_NREFS times in <dataset>_scale (see
+ *  compat_hyper.h), so that the readers can time decoding it.  Create and
+ *  write rates go to TIMEPATH.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include "hdf5.h"
+#include "compat_timing.h"
+#include "compat_hyper.h"
 
 /* The test file */
 #define FILENAME            "hyper_compat.h5"
 #define POWER32             4294967296      /* 2^32 */
 
 /* Datasets added */
-#define DSET                "dset"
 #define REF_NX_REG_DSET     "ref_nx32_reg_dset"
 #define REF_NX_IRR_DSET     "ref_nx32_irr_dset"
 #define REF_NX_PT_DSET      "ref_nx32_pt_dset"
@@ -55,6 +61,7 @@ main(int ac, char **av)
     hsize_t total_particles = numparticles * 513;
     hsize_t vdsdims[1] = {total_particles};     /* Dataset dimension size */
     int ret;                /* Return status */
+    int nerrors = 0;        /* Failed writes */
 
     ref_wbuf = calloc(sizeof(hdset_reg_ref_t), (size_t)1);
 
@@ -63,7 +70,7 @@ main(int ac, char **av)
 
     /* Create a dataset */
     sid = H5Screate_simple(1, vdsdims, NULL);
-    did = H5Dcreate2(fid, DSET, H5T_NATIVE_UINT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    did = H5Dcreate2(fid, HYPER_DSET, H5T_NATIVE_UINT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
     /* Create a dataset with dataset region reference */
     ref_dims[0] = 1;
@@ -78,10 +85,14 @@ main(int ac, char **av)
     ret = H5Sselect_hyperslab(sid, H5S_SELECT_SET, &ref_start, &ref_stride, &ref_count, &ref_block);
     
     /* Create the reference */
-    ret = H5Rcreate(&ref_wbuf[0], fid, DSET, H5R_DATASET_REGION, sid);
+    ret = H5Rcreate(&ref_wbuf[0], fid, HYPER_DSET, H5R_DATASET_REGION, sid);
 
     /* Write the reference to the referenced dataset */
-    ret = H5Dwrite(ref_did1, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf);
+    if(H5Dwrite(ref_did1, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf) < 0
+            || hyper_write_scale(fid, REF_NX_REG_DSET, sid) < 0) {
+        fprintf(stderr, "%s: writing %s failed\n", av[0], REF_NX_REG_DSET);
+        nerrors++;
+    }
 
     /* Generate irregular hyperslab not exceeding 32 */
     ref_start = 8;
@@ -91,13 +102,17 @@ main(int ac, char **av)
     ret = H5Sselect_hyperslab(sid, H5S_SELECT_OR, &ref_start, &ref_stride, &ref_count, &ref_block);
 
     /* Create the reference */
-    ret = H5Rcreate(&ref_wbuf[0], fid, DSET, H5R_DATASET_REGION, sid);
+    ret = H5Rcreate(&ref_wbuf[0], fid, HYPER_DSET, H5R_DATASET_REGION, sid);
 
     /* Create a dataset with dataset region reference */
     ref_did2  = H5Dcreate2(fid, REF_NX_IRR_DSET, H5T_STD_REF_DSETREG, ref_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
     /* Write the reference to the referenced dataset */
-    ret = H5Dwrite(ref_did2, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf);
+    if(H5Dwrite(ref_did2, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf) < 0
+            || hyper_write_scale(fid, REF_NX_IRR_DSET, sid) < 0) {
+        fprintf(stderr, "%s: writing %s failed\n", av[0], REF_NX_IRR_DSET);
+        nerrors++;
+    }
 
 
     /* Generate point selection not exceeding 32 */
@@ -114,7 +129,11 @@ main(int ac, char **av)
     ref_did3  = H5Dcreate2(fid, REF_NX_PT_DSET, H5T_STD_REF_DSETREG, ref_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
 
     /* Write the reference to the referenced dataset */
-    ret = H5Dwrite(ref_did3, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf);
+    if(H5Dwrite(ref_did3, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf) < 0
+            || hyper_write_scale(fid, REF_NX_PT_DSET, sid) < 0) {
+        fprintf(stderr, "%s: writing %s failed\n", av[0], REF_NX_PT_DSET);
+        nerrors++;
+    }
 
     /* Closing */
     H5Dclose(ref_did1);
@@ -124,5 +143,8 @@ main(int ac, char **av)
     H5Dclose(did);
     H5Sclose(sid);
     H5Fclose(fid);
+    free(ref_wbuf);
+
+    return nerrors ? 1 : 0;
 }
 
@@ -0,0 +1,87 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API gen_raw_compat.c
+ *
+ *  Create raw_compat.h5 with one large contiguous integer dataset, RAW_DSET,
+ *  in which element k holds the value k (the same pattern as dset2 in
+ *  gen_compat.c).  read_raw_compat.c checks the raw bytes of this dataset
+ *  directly in the file.
+ *
+ *  RAW_NELMTS defaults to 4 MB of data; compile with e.g.
+ *  -DRAW_NELMTS=268435456 for a 1 GB dataset.
+ */
+
+#include "hdf5.h"
+#include <stdlib.h>
+
+/* The test file */
+#define FILENAME    "raw_compat.h5"
+
+/* The contiguous dataset */
+#define RAW_DSET    "/raw"
+
+#ifndef RAW_NELMTS
+#define RAW_NELMTS  1048576
+#endif
+
+/* Elements written per H5Dwrite() call */
+#define RAW_SLAB    1048576
+
+int main(void)
+{
+    hid_t fid;          /* File ID */
+    hid_t sid;          /* File dataspace ID */
+    hid_t mid;          /* Memory dataspace ID */
+    hid_t did;          /* Dataset ID */
+    hsize_t dims[1];    /* Dataset dimension size */
+    hsize_t start[1];   /* Starting location of the slab */
+    hsize_t count[1];   /* Elements in the slab */
+    int *buf;           /* Buffer for one slab */
+    hsize_t k, i;
+
+    buf = malloc(sizeof(int) * RAW_SLAB);
+
+    /* Create the test file */
+    fid = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+
+    /* Create the contiguous dataset */
+    dims[0] = RAW_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    did = H5Dcreate(fid, RAW_DSET, H5T_NATIVE_INT, sid, H5P_DEFAULT);
+
+    /* Write it one slab at a time */
+    for(k = 0; k < (hsize_t)RAW_NELMTS; k += count[0]) {
+        start[0] = k;
+        count[0] = (hsize_t)RAW_NELMTS - k < RAW_SLAB ? (hsize_t)RAW_NELMTS - k : RAW_SLAB;
+        for(i = 0; i < count[0]; i++)
+            buf[i] = (int)(k + i);
+
+        mid = H5Screate_simple(1, count, NULL);
+        H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL);
+        H5Dwrite(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, buf);
+        H5Sclose(mid);
+    }
+
+    /* Closing */
+    H5Dclose(did);
+    H5Sclose(sid);
+    H5Fclose(fid);
+
+    free(buf);
+
+    return 0;
+} /* main() */
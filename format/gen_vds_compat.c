@@ -0,0 +1,79 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API gen_vds_compat.c
+ *
+ *  Create the source files of the virtual dataset test, vds_src_0.h5 to
+ *  vds_src_<VDS_NSOURCES - 1>.h5, and an empty vds_compat.h5 for
+ *  tests/t_vds.c to add the virtual datasets to.  Source file s holds
+ *  VDS_SRC_NELMTS integers in VDS_SRC_DSET, element i holding
+ *  s * VDS_SRC_NELMTS + i, so that the virtual datasets hold the value k
+ *  at element k.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The test file */
+#define FILENAME        "vds_compat.h5"
+
+/* The source files, as in tests/t_vds.c */
+#define VDS_SRC_FILE    "vds_src_%d.h5"
+#define VDS_SRC_DSET    "/data"
+
+#ifndef VDS_NSOURCES
+#define VDS_NSOURCES    256
+#endif
+#define VDS_SRC_NELMTS  16384
+
+int main(void)
+{
+    hid_t fid;          /* File ID */
+    hid_t sid;          /* Dataspace ID */
+    hid_t did;          /* Dataset ID */
+    hsize_t dims[1];    /* Dataset dimension size */
+    char name[64];
+    int *buf;
+    int s, i;
+
+    buf = (int *)malloc(sizeof(int) * VDS_SRC_NELMTS);
+
+    dims[0] = VDS_SRC_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+
+    /* Create the source files */
+    for(s = 0; s < VDS_NSOURCES; s++) {
+        for(i = 0; i < VDS_SRC_NELMTS; i++)
+            buf[i] = s * VDS_SRC_NELMTS + i;
+
+        sprintf(name, VDS_SRC_FILE, s);
+        fid = H5Fcreate(name, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        did = H5Dcreate(fid, VDS_SRC_DSET, H5T_NATIVE_INT, sid, H5P_DEFAULT);
+        H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+        H5Dclose(did);
+        H5Fclose(fid);
+    }
+    H5Sclose(sid);
+
+    /* Create the test file */
+    fid = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    H5Fclose(fid);
+
+    free(buf);
+
+    return 0;
+} /* main() */
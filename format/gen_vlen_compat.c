@@ -0,0 +1,60 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API gen_vlen_compat.c
+ *
+ *  Create vlen_compat.h5 with the variable-length fixture of compat_vlen.h
+ *  in the group VLEN_GROUP.  tests/t_vlen.c adds the same objects with the
+ *  writer under test.
+ *
+ *  The write rates go to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include "compat_timing.h"
+#include "compat_vlen.h"
+
+/* The test file */
+#define FILENAME    "vlen_compat.h5"
+
+#define VLEN_GROUP  "/gen"
+
+int main(void)
+{
+    hid_t fid;          /* File ID */
+    hid_t gid;          /* Group ID */
+    double t;
+
+    /* Create the test file */
+    fid = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    gid = H5Gcreate(fid, VLEN_GROUP, 0);
+
+    t = compat_time_now();
+    vlen_write_strings(gid, (hsize_t)VLEN_NELMTS, 0);
+    compat_timing("t_vlen", "gen_strings_write", (double)VLEN_NELMTS / (compat_time_now() - t), "elmts/s");
+
+    t = compat_time_now();
+    vlen_write_sequences(gid, (hsize_t)VLEN_NELMTS);
+    compat_timing("t_vlen", "gen_sequences_write", (double)VLEN_NELMTS / (compat_time_now() - t), "elmts/s");
+
+    vlen_write_strings(gid, (hsize_t)VLEN_NATTR, 1);
+
+    /* Closing */
+    H5Gclose(gid);
+    H5Fclose(fid);
+
+    return 0;
+} /* main() */
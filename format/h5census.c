@@ -0,0 +1,1052 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This does NOT use the HDF5 library.  Compile it with the native compiler:
+ *      cc -o h5census.out h5census.c
+ *
+ *  Usage:  h5census.out <file>
+ *
+ *  Read the on-disk structures of an HDF5 file directly and print a census
+ *  of the format versions in use: the superblock, and for every object
+ *  reachable from the root group its path, object header version, number
+ *  of header chunks and bytes, how its links and attributes are stored
+ *  (symbol table, compact, or dense in a fractal heap and v2 B-tree), and
+ *  for datasets the layout and chunk index type with the raw data bytes.
+ *  Totals follow at the end.
+ *
+ *  Being independent of any library release, the census is the same
+ *  whichever release runs the tests, and it is quick enough to run after
+ *  every test in check_format.sh.  It explains why a reader fails and
+ *  where file growth comes from.
+ *
+ *  Only the structures written by the tests are decoded.  Anything else is
+ *  shown as "?" rather than guessed at.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_PATH        1024    /* Longest object path printed */
+
+/* Object header message types used below */
+#define MSG_DATASPACE   0x0001
+#define MSG_LINFO       0x0002
+#define MSG_DATATYPE    0x0003
+#define MSG_FILL_OLD    0x0004
+#define MSG_FILL        0x0005
+#define MSG_LINK        0x0006
+#define MSG_LAYOUT      0x0008
+#define MSG_GINFO       0x000A
+#define MSG_PLINE       0x000B
+#define MSG_ATTR        0x000C
+#define MSG_CONT        0x0010
+#define MSG_STAB        0x0011
+#define MSG_AINFO       0x0015
+
+/* Chunk index types: the version 1 B-tree, then those of layout version 4 */
+static const char *chunk_index_names[] = {
+    "btree1", "single", "implicit", "farray", "earray", "btree2"
+};
+#define NINDEX_TYPES    6
+
+/* The file and what is known about it */
+typedef struct {
+    const unsigned char *buf;   /* The mapped file */
+    unsigned long long size;    /* File size */
+    unsigned long long base;    /* Base address from the superblock */
+    int sizeof_addr;            /* Size of file addresses */
+    int sizeof_size;            /* Size of lengths */
+
+    /* Object headers already visited, with the first path to each */
+    unsigned long long *seen_addr;
+    char **seen_path;
+    size_t nseen, aseen;
+
+    /* Totals */
+    unsigned long objects, ohdr_v1, ohdr_v2, hdr_chunks;
+    unsigned long long hdr_bytes, raw_bytes;
+    unsigned long symtab_groups, compact_groups, dense_groups;
+    unsigned long compact_attrs, dense_attr_objects;
+    unsigned long fractal_heaps, v2_btrees, shared_mesgs;
+    unsigned long chunk_index[NINDEX_TYPES];
+    unsigned long unknown_raw;  /* Datasets left out of raw_bytes */
+    unsigned long unknown;
+} census_t;
+
+/* A link found in a group */
+typedef struct {
+    char name[256];
+    int type;                   /* 0 hard, 1 soft, 64 external */
+    unsigned long long addr;    /* Object header address for hard links */
+    char value[512];            /* Target for soft and external links */
+} link_t;
+
+/* What the object header messages say about one object */
+typedef struct {
+    int version;                /* Object header version */
+    int nchunks;                /* Header chunks, including the first */
+    unsigned long long bytes;   /* Bytes in all header chunks */
+    int nmesgs;
+
+    /* Groups */
+    int stab;                   /* Symbol table message present */
+    unsigned long long btree_addr, lheap_addr;
+    int linfo;                  /* Link info message present */
+    unsigned long long link_fheap, link_name_bt2, link_corder_bt2;
+    int ginfo;
+    const unsigned char **links;    /* Compact link messages */
+    int nlinks, alinks;
+
+    /* Datasets and datatypes */
+    int layout_version, layout_class, chunk_index, layout_rank;
+    unsigned long long layout_addr, raw_bytes;
+    unsigned long nchunks_raw;
+    int dtype_version, dtype_class, dtype_shared;
+    int dspace_version;
+    int pline_version, nfilters;
+    int fill_version;
+
+    /* Attributes */
+    int nattrs, attr_version;
+    int ainfo;
+    unsigned long long attr_fheap, attr_name_bt2;
+    unsigned long long dense_nattrs;
+} obj_info_t;
+
+/* A fractal heap, enough of it to find managed objects */
+typedef struct {
+    unsigned long long addr;
+    int heap_id_len;
+    int filtered;
+    int width;
+    unsigned long long start_block, max_direct;
+    int max_heap_bits;
+    unsigned long long root_addr;
+    int root_rows;
+    int heap_off_size;
+    int max_direct_rows;
+    int first_row_bits;
+    unsigned long long nobjs;
+} fheap_t;
+
+static void walk(census_t *c, unsigned long long addr, const char *path);
+
+/* Decode an n-byte little-endian value */
+static unsigned long long
+dec(const unsigned char *p, int n)
+{
+    unsigned long long v = 0;
+    int i;
+
+    for(i = n - 1; i >= 0; i--)
+        v = (v << 8) | p[i];
+
+    return(v);
+}
+
+/* Is this the undefined address for the file's address size? */
+static int
+undef_addr(const census_t *c, unsigned long long a)
+{
+    if(c->sizeof_addr >= 8)
+        return(a == ~0ULL);
+
+    return(a == (1ULL << (8 * c->sizeof_addr)) - 1);
+}
+
+/* Return a pointer to len bytes at a file address, or NULL if outside */
+static const unsigned char *
+at(const census_t *c, unsigned long long addr, unsigned long long len)
+{
+    unsigned long long off = c->base + addr;
+
+    if(off < c->base || off > c->size || len > c->size - off)
+        return(NULL);
+
+    return(c->buf + off);
+}
+
+/* Number of bits needed for a power of two */
+static int
+log2_of2(unsigned long long n)
+{
+    int r = 0;
+
+    while(n > 1) {
+        n >>= 1;
+        r++;
+    }
+
+    return(r);
+}
+
+/* Bytes needed to encode values up to n, as the library computes it */
+static int
+limit_enc_size(unsigned long long n)
+{
+    return(log2_of2(n) / 8 + 1);
+}
+
+static void
+add_link(obj_info_t *oi, const unsigned char *p)
+{
+    if(oi->nlinks == oi->alinks) {
+        oi->alinks = oi->alinks ? 2 * oi->alinks : 16;
+        oi->links = realloc(oi->links, sizeof(*oi->links) * (size_t)oi->alinks);
+    }
+    oi->links[oi->nlinks++] = p;
+}
+
+/* Record one object header message */
+static void
+message(census_t *c, obj_info_t *oi, unsigned type, unsigned flags,
+        const unsigned char *p, unsigned size)
+{
+    const unsigned char *q;
+    int A = c->sizeof_addr, L = c->sizeof_size;
+
+    oi->nmesgs++;
+    if(size == 0)
+        return;
+
+    /* Shared messages only hold a reference to the real one */
+    if(flags & 0x02) {
+        c->shared_mesgs++;
+        if(type == MSG_DATATYPE)
+            oi->dtype_shared = 1;
+        return;
+    }
+
+    switch(type) {
+        case MSG_DATASPACE:
+            oi->dspace_version = p[0];
+            break;
+
+        case MSG_DATATYPE:
+            oi->dtype_version = p[0] >> 4;
+            oi->dtype_class = p[0] & 0x0f;
+            break;
+
+        case MSG_FILL_OLD:
+            if(!oi->fill_version)
+                oi->fill_version = -1;
+            break;
+
+        case MSG_FILL:
+            oi->fill_version = p[0];
+            break;
+
+        case MSG_LINK:
+            add_link(oi, p);
+            break;
+
+        case MSG_LINFO:
+            oi->linfo = 1;
+            q = p + 2 + ((p[1] & 0x01) ? 8 : 0);
+            oi->link_fheap = dec(q, A);
+            oi->link_name_bt2 = dec(q + A, A);
+            oi->link_corder_bt2 = (p[1] & 0x02) ? dec(q + 2 * A, A) : ~0ULL;
+            break;
+
+        case MSG_GINFO:
+            oi->ginfo = 1;
+            break;
+
+        case MSG_LAYOUT:
+            oi->layout_version = p[0];
+            if(p[0] < 3) {
+                /* Version 1 and 2: rank, class, reserved, address */
+                oi->layout_rank = p[1];
+                oi->layout_class = p[2];
+                if(oi->layout_class != 0)
+                    oi->layout_addr = dec(p + 8, A);
+                if(oi->layout_class == 2)
+                    oi->chunk_index = 0;
+            } else {
+                oi->layout_class = p[1];
+                if(oi->layout_class == 1) {
+                    oi->layout_addr = dec(p + 2, A);
+                    oi->raw_bytes = dec(p + 2 + A, L);
+                } else if(oi->layout_class == 0) {
+                    oi->raw_bytes = dec(p + 2, 2);
+                } else if(oi->layout_class == 2 && p[0] == 3) {
+                    oi->layout_rank = p[2];
+                    oi->layout_addr = dec(p + 3, A);
+                    oi->chunk_index = 0;
+                } else if(oi->layout_class == 2) {
+                    /* Version 4: flags, rank, encoded dim size, dims, index type */
+                    oi->layout_rank = p[3];
+                    q = p + 5 + p[3] * p[4];
+                    oi->chunk_index = q[0];
+                    if(oi->chunk_index < 1 || oi->chunk_index >= NINDEX_TYPES)
+                        oi->chunk_index = -2;
+                }
+            }
+            break;
+
+        case MSG_PLINE:
+            oi->pline_version = p[0];
+            oi->nfilters = p[1];
+            break;
+
+        case MSG_ATTR:
+            oi->nattrs++;
+            oi->attr_version = p[0];
+            break;
+
+        case MSG_AINFO:
+            oi->ainfo = 1;
+            q = p + 2 + ((p[1] & 0x01) ? 2 : 0);
+            oi->attr_fheap = dec(q, A);
+            oi->attr_name_bt2 = dec(q + A, A);
+            break;
+
+        case MSG_STAB:
+            oi->stab = 1;
+            oi->btree_addr = dec(p, A);
+            oi->lheap_addr = dec(p + A, A);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Object header version 1: messages in chunks of 8-byte aligned entries */
+static int
+ohdr_v1(census_t *c, unsigned long long addr, obj_info_t *oi)
+{
+    unsigned long long chunk_addr[64], chunk_len[64];
+    int nchunk = 1, i;
+    const unsigned char *h;
+
+    if((h = at(c, addr, 16)) == NULL || h[0] != 1)
+        return(-1);
+    oi->version = 1;
+    chunk_addr[0] = addr + 16;
+    chunk_len[0] = dec(h + 8, 4);
+    oi->bytes = 16;
+
+    for(i = 0; i < nchunk; i++) {
+        const unsigned char *p = at(c, chunk_addr[i], chunk_len[i]);
+        const unsigned char *end;
+
+        if(p == NULL)
+            return(-1);
+        end = p + chunk_len[i];
+        oi->bytes += chunk_len[i];
+
+        while(p + 8 <= end) {
+            unsigned type = (unsigned)dec(p, 2);
+            unsigned size = (unsigned)dec(p + 2, 2);
+            unsigned flags = p[4];
+
+            if(p + 8 + size > end)
+                break;
+            if(type == MSG_CONT && nchunk < 64) {
+                chunk_addr[nchunk] = dec(p + 8, c->sizeof_addr);
+                chunk_len[nchunk] = dec(p + 8 + c->sizeof_addr, c->sizeof_size);
+                nchunk++;
+            } else if(type != 0)
+                message(c, oi, type, flags, p + 8, size);
+            p += 8 + size;
+        }
+    }
+    oi->nchunks = nchunk;
+
+    return(0);
+}
+
+/* Object header version 2: "OHDR" prefix, "OCHK" continuation chunks */
+static int
+ohdr_v2(census_t *c, unsigned long long addr, obj_info_t *oi)
+{
+    unsigned long long chunk_addr[64], chunk_len[64];
+    int nchunk = 1, i;
+    const unsigned char *h;
+    unsigned hflags;
+    unsigned long long prefix;
+
+    if((h = at(c, addr, 8)) == NULL || memcmp(h, "OHDR", 4) != 0 || h[4] != 2)
+        return(-1);
+    oi->version = 2;
+    hflags = h[5];
+    prefix = 6;
+    if(hflags & 0x20)
+        prefix += 16;
+    if(hflags & 0x10)
+        prefix += 4;
+    if((h = at(c, addr, prefix + 8)) == NULL)
+        return(-1);
+    chunk_len[0] = dec(h + prefix, 1 << (hflags & 0x03));
+    prefix += (unsigned long long)(1 << (hflags & 0x03));
+    chunk_addr[0] = addr + prefix;
+    oi->bytes = prefix + 4;
+
+    for(i = 0; i < nchunk; i++) {
+        const unsigned char *p = at(c, chunk_addr[i], chunk_len[i]);
+        const unsigned char *end;
+        unsigned mhdr = (hflags & 0x04) ? 6 : 4;
+
+        if(p == NULL)
+            return(-1);
+        end = p + chunk_len[i];
+        oi->bytes += chunk_len[i];
+
+        while(p + mhdr <= end) {
+            unsigned type = p[0];
+            unsigned size = (unsigned)dec(p + 1, 2);
+            unsigned flags = p[3];
+
+            if(p + mhdr + size > end)
+                break;
+            if(type == MSG_CONT && nchunk < 64) {
+                /* The continuation block holds "OCHK", messages, checksum */
+                chunk_addr[nchunk] = dec(p + mhdr, c->sizeof_addr) + 4;
+                chunk_len[nchunk] = dec(p + mhdr + c->sizeof_addr, c->sizeof_size) - 8;
+                oi->bytes += 8;
+                nchunk++;
+            } else if(type != 0)
+                message(c, oi, type, flags, p + mhdr, size);
+            p += mhdr + size;
+        }
+    }
+    oi->nchunks = nchunk;
+
+    return(0);
+}
+
+/* Decode a link message (version 1) */
+static int
+decode_link(census_t *c, const unsigned char *p, link_t *lk)
+{
+    unsigned flags;
+    unsigned long long nlen, vlen;
+
+    if(p == NULL || p[0] != 1)
+        return(-1);
+    flags = p[1];
+    p += 2;
+    lk->type = 0;
+    if(flags & 0x08)
+        lk->type = *p++;
+    if(flags & 0x04)
+        p += 8;
+    if(flags & 0x10)
+        p++;
+    nlen = dec(p, 1 << (flags & 0x03));
+    p += 1 << (flags & 0x03);
+    if(nlen >= sizeof(lk->name))
+        nlen = sizeof(lk->name) - 1;
+    memcpy(lk->name, p, (size_t)nlen);
+    lk->name[nlen] = '\0';
+    p += nlen;
+
+    lk->value[0] = '\0';
+    if(lk->type == 0)
+        lk->addr = dec(p, c->sizeof_addr);
+    else {
+        vlen = dec(p, 2);
+        if(vlen >= sizeof(lk->value))
+            vlen = sizeof(lk->value) - 1;
+        memcpy(lk->value, p + 2, (size_t)vlen);
+        lk->value[vlen] = '\0';
+        /* External links hold "file\0object" after a flags byte */
+        if(lk->type == 64 && vlen > 1) {
+            size_t flen = strlen(lk->value + 1);
+
+            memmove(lk->value, lk->value + 1, (size_t)vlen - 1);
+            lk->value[vlen - 1] = '\0';
+            if(flen < vlen - 1)
+                lk->value[flen] = ':';
+        }
+    }
+
+    return(0);
+}
+
+/* Read a fractal heap header */
+static int
+fheap_open(census_t *c, unsigned long long addr, fheap_t *fh)
+{
+    const unsigned char *p;
+    int A = c->sizeof_addr, L = c->sizeof_size;
+
+    if((p = at(c, addr, 22 + 12 * L + 3 * A)) == NULL || memcmp(p, "FRHP", 4) != 0)
+        return(-1);
+    memset(fh, 0, sizeof(*fh));
+    fh->addr = addr;
+    fh->heap_id_len = (int)dec(p + 5, 2);
+    fh->filtered = dec(p + 7, 2) > 0;
+    p += 9 + 1 + 4 + L + A + L + A + L + L + L;
+    fh->nobjs = dec(p, L);
+    p += 5 * L;
+    fh->width = (int)dec(p, 2);
+    fh->start_block = dec(p + 2, L);
+    fh->max_direct = dec(p + 2 + L, L);
+    fh->max_heap_bits = (int)dec(p + 2 + 2 * L, 2);
+    fh->root_addr = dec(p + 6 + 2 * L, A);
+    fh->root_rows = (int)dec(p + 6 + 2 * L + A, 2);
+
+    fh->heap_off_size = (fh->max_heap_bits + 7) / 8;
+    fh->max_direct_rows = log2_of2(fh->max_direct) - log2_of2(fh->start_block) + 2;
+    fh->first_row_bits = log2_of2(fh->start_block) + log2_of2((unsigned long long)fh->width);
+    c->fractal_heaps++;
+
+    return(0);
+}
+
+/* Size of the blocks in one row of the doubling table */
+static unsigned long long
+row_block_size(const fheap_t *fh, int row)
+{
+    return(row == 0 ? fh->start_block : fh->start_block << (row - 1));
+}
+
+/* Find the file address of heap offset off inside an indirect block */
+static const unsigned char *
+fheap_iblock(census_t *c, const fheap_t *fh, unsigned long long iaddr,
+        int nrows, unsigned long long ioff, unsigned long long off)
+{
+    const unsigned char *p;
+    int A = c->sizeof_addr, L = c->sizeof_size;
+    int row, col, entry = 0;
+    unsigned long long boff = ioff;
+    unsigned long long hdr = 5 + (unsigned long long)A + (unsigned long long)fh->heap_off_size;
+
+    if((p = at(c, iaddr, hdr)) == NULL || memcmp(p, "FHIB", 4) != 0)
+        return(NULL);
+    p += hdr;
+
+    for(row = 0; row < nrows; row++) {
+        unsigned long long bsize = row_block_size(fh, row);
+
+        for(col = 0; col < fh->width; col++, entry++) {
+            unsigned long long child;
+            int direct = row < fh->max_direct_rows;
+
+            if(direct) {
+                child = dec(p, A);
+                p += A + (fh->filtered ? L + 4 : 0);
+            } else {
+                child = dec(p, A);
+                p += A;
+            }
+            if(off >= boff && off < boff + bsize && !undef_addr(c, child)) {
+                if(direct)
+                    return(at(c, child + (off - boff), 1));
+                return(fheap_iblock(c, fh, child,
+                            log2_of2(bsize) - fh->first_row_bits + 1, boff, off));
+            }
+            boff += bsize;
+        }
+    }
+
+    return(NULL);
+}
+
+/* Return a pointer to a managed object from its heap ID */
+static const unsigned char *
+fheap_object(census_t *c, const fheap_t *fh, const unsigned char *id)
+{
+    unsigned long long off;
+
+    /* Only managed objects (type 0) are used for links */
+    if(((id[0] >> 4) & 0x03) != 0)
+        return(NULL);
+    off = dec(id + 1, fh->heap_off_size);
+
+    if(fh->root_rows == 0)
+        return(at(c, fh->root_addr + off, 1));
+
+    return(fheap_iblock(c, fh, fh->root_addr, fh->root_rows, 0, off));
+}
+
+/* v2 B-tree geometry, as the library derives it from the header */
+typedef struct {
+    unsigned long long node_size;
+    int rec_size;
+    int depth;
+    int max_nrec_size;
+    unsigned long long max_nrec[16];
+    unsigned long long cum_max_nrec[16];
+    int cum_max_nrec_size[16];
+} bt2_t;
+
+/* Visit every record in a v2 B-tree node */
+static void
+bt2_node(census_t *c, const bt2_t *bt, unsigned long long addr, unsigned nrec,
+        int depth, void (*cb)(census_t *, const unsigned char *, void *), void *udata)
+{
+    const unsigned char *p;
+    unsigned u;
+
+    if((p = at(c, addr, bt->node_size)) == NULL)
+        return;
+    if(depth == 0) {
+        if(memcmp(p, "BTLF", 4) != 0)
+            return;
+        for(u = 0; u < nrec; u++)
+            cb(c, p + 6 + (unsigned long long)u * bt->rec_size, udata);
+    } else {
+        const unsigned char *ptr;
+        int psize = c->sizeof_addr + bt->max_nrec_size
+                + (depth > 1 ? bt->cum_max_nrec_size[depth - 1] : 0);
+
+        if(memcmp(p, "BTIN", 4) != 0)
+            return;
+        ptr = p + 6 + (unsigned long long)nrec * bt->rec_size;
+        for(u = 0; u <= nrec; u++, ptr += psize) {
+            unsigned long long child = dec(ptr, c->sizeof_addr);
+            unsigned cnrec = (unsigned)dec(ptr + c->sizeof_addr, bt->max_nrec_size);
+
+            bt2_node(c, bt, child, cnrec, depth - 1, cb, udata);
+            if(u < nrec)
+                cb(c, p + 6 + (unsigned long long)u * bt->rec_size, udata);
+        }
+    }
+}
+
+/* Visit every record in a v2 B-tree; return the number of records */
+static unsigned long long
+bt2_iterate(census_t *c, unsigned long long addr,
+        void (*cb)(census_t *, const unsigned char *, void *), void *udata)
+{
+    const unsigned char *p;
+    bt2_t bt;
+    unsigned long long root, nrec_total;
+    unsigned root_nrec;
+    int d, psize;
+
+    if((p = at(c, addr, 22 + (unsigned long long)c->sizeof_addr + c->sizeof_size)) == NULL
+            || memcmp(p, "BTHD", 4) != 0)
+        return(0);
+    c->v2_btrees++;
+    bt.node_size = dec(p + 6, 4);
+    bt.rec_size = (int)dec(p + 10, 2);
+    bt.depth = (int)dec(p + 12, 2);
+    root = dec(p + 16, c->sizeof_addr);
+    root_nrec = (unsigned)dec(p + 16 + c->sizeof_addr, 2);
+    nrec_total = dec(p + 18 + c->sizeof_addr, c->sizeof_size);
+    if(bt.depth >= 16 || bt.rec_size <= 0 || undef_addr(c, root))
+        return(nrec_total);
+
+    bt.max_nrec[0] = (bt.node_size - 10) / (unsigned long long)bt.rec_size;
+    bt.cum_max_nrec[0] = bt.max_nrec[0];
+    bt.cum_max_nrec_size[0] = 0;
+    bt.max_nrec_size = limit_enc_size(bt.max_nrec[0]);
+    for(d = 1; d <= bt.depth; d++) {
+        psize = c->sizeof_addr + bt.max_nrec_size + (d > 1 ? bt.cum_max_nrec_size[d - 1] : 0);
+        bt.max_nrec[d] = (bt.node_size - (10 + (unsigned long long)psize))
+                / (unsigned long long)(bt.rec_size + psize);
+        bt.cum_max_nrec[d] = (bt.max_nrec[d] + 1) * bt.cum_max_nrec[d - 1] + bt.max_nrec[d];
+        bt.cum_max_nrec_size[d] = limit_enc_size(bt.cum_max_nrec[d]);
+    }
+
+    if(cb)
+        bt2_node(c, &bt, root, root_nrec, bt.depth, cb, udata);
+
+    return(nrec_total);
+}
+
+/* Links found while iterating a dense group */
+typedef struct {
+    fheap_t *fh;
+    link_t *links;
+    int n, a;
+} dense_links_t;
+
+/* v2 B-tree callback for link name index records: hash, heap ID */
+static void
+dense_link_cb(census_t *c, const unsigned char *rec, void *udata)
+{
+    dense_links_t *dl = (dense_links_t *)udata;
+    const unsigned char *obj = fheap_object(c, dl->fh, rec + 4);
+
+    if(dl->n == dl->a) {
+        dl->a = dl->a ? 2 * dl->a : 64;
+        dl->links = realloc(dl->links, sizeof(link_t) * (size_t)dl->a);
+    }
+    if(obj && decode_link(c, obj, &dl->links[dl->n]) == 0)
+        dl->n++;
+    else
+        c->unknown++;
+}
+
+/* Visit a version 1 B-tree of group nodes, collecting symbol table entries */
+static void
+stab_btree(census_t *c, unsigned long long addr, unsigned long long heap_data,
+        link_t **links, int *n, int *a)
+{
+    const unsigned char *p;
+    int A = c->sizeof_addr, L = c->sizeof_size;
+    unsigned level, nentries, u, s;
+
+    if((p = at(c, addr, 8 + 2 * (unsigned long long)A)) == NULL || memcmp(p, "TREE", 4) != 0 || p[4] != 0)
+        return;
+    level = p[5];
+    nentries = (unsigned)dec(p + 6, 2);
+    p += 8 + 2 * A;
+    if(at(c, addr, 8 + 2 * (unsigned long long)A + (unsigned long long)nentries * (L + A) + L) == NULL)
+        return;
+
+    for(u = 0; u < nentries; u++) {
+        unsigned long long child = dec(p + L + (unsigned long long)u * (L + A), A);
+
+        if(level > 0) {
+            stab_btree(c, child, heap_data, links, n, a);
+            continue;
+        }
+
+        /* A symbol table node */
+        {
+            const unsigned char *sn = at(c, child, 8);
+            unsigned nsyms;
+            int esize = L + A + 24;
+
+            if(sn == NULL || memcmp(sn, "SNOD", 4) != 0)
+                continue;
+            nsyms = (unsigned)dec(sn + 6, 2);
+            if((sn = at(c, child, 8 + (unsigned long long)nsyms * esize)) == NULL)
+                continue;
+            for(s = 0; s < nsyms; s++) {
+                const unsigned char *e = sn + 8 + (unsigned long long)s * esize;
+                const unsigned char *name = at(c, heap_data + dec(e, L), 1);
+                link_t *lk;
+
+                if(*n == *a) {
+                    *a = *a ? 2 * *a : 64;
+                    *links = realloc(*links, sizeof(link_t) * (size_t)*a);
+                }
+                lk = &(*links)[*n];
+                snprintf(lk->name, sizeof(lk->name), "%s", name ? (const char *)name : "?");
+                lk->addr = dec(e + L, A);
+                lk->value[0] = '\0';
+                lk->type = 0;
+                /* Cache type 2 is a soft link; scratch holds the value offset */
+                if(dec(e + L + A, 4) == 2) {
+                    const unsigned char *v = at(c, heap_data + dec(e + L + A + 8, 4), 1);
+
+                    lk->type = 1;
+                    snprintf(lk->value, sizeof(lk->value), "%s", v ? (const char *)v : "?");
+                }
+                (*n)++;
+            }
+        }
+    }
+}
+
+/* Sum the chunk sizes of a version 1 B-tree chunk index */
+static void
+chunk_btree(census_t *c, unsigned long long addr, int rank, obj_info_t *oi)
+{
+    const unsigned char *p;
+    int A = c->sizeof_addr;
+    int ksize = 8 + 8 * rank;
+    unsigned level, nentries, u;
+
+    if((p = at(c, addr, 8 + 2 * (unsigned long long)A)) == NULL || memcmp(p, "TREE", 4) != 0 || p[4] != 1)
+        return;
+    level = p[5];
+    nentries = (unsigned)dec(p + 6, 2);
+    if((p = at(c, addr, 8 + 2 * (unsigned long long)A + (unsigned long long)nentries * (ksize + A) + ksize)) == NULL)
+        return;
+    p += 8 + 2 * A;
+
+    for(u = 0; u < nentries; u++) {
+        const unsigned char *key = p + (unsigned long long)u * (ksize + A);
+        unsigned long long child = dec(key + ksize, A);
+
+        if(level > 0)
+            chunk_btree(c, child, rank, oi);
+        else {
+            oi->raw_bytes += dec(key, 4);
+            oi->nchunks_raw++;
+        }
+    }
+}
+
+/* Has this object header been seen under another path? */
+static const char *
+seen(census_t *c, unsigned long long addr, const char *path)
+{
+    size_t u;
+
+    for(u = 0; u < c->nseen; u++)
+        if(c->seen_addr[u] == addr)
+            return(c->seen_path[u]);
+
+    if(c->nseen == c->aseen) {
+        c->aseen = c->aseen ? 2 * c->aseen : 256;
+        c->seen_addr = realloc(c->seen_addr, sizeof(*c->seen_addr) * c->aseen);
+        c->seen_path = realloc(c->seen_path, sizeof(*c->seen_path) * c->aseen);
+    }
+    c->seen_addr[c->nseen] = addr;
+    c->seen_path[c->nseen] = strdup(path);
+    c->nseen++;
+
+    return(NULL);
+}
+
+/* Print one object and count it in the totals */
+static void
+report(census_t *c, const char *path, obj_info_t *oi, const char *links)
+{
+    const char *kind;
+
+    if(oi->layout_class >= 0)
+        kind = "dataset";
+    else if(oi->stab || oi->linfo || oi->ginfo || oi->nlinks)
+        kind = "group";
+    else if(oi->dtype_version || oi->dtype_shared)
+        kind = "datatype";
+    else
+        kind = "object";
+
+    c->objects++;
+    c->hdr_chunks += (unsigned long)oi->nchunks;
+    c->hdr_bytes += oi->bytes;
+    if(oi->version == 1)
+        c->ohdr_v1++;
+    else
+        c->ohdr_v2++;
+
+    printf("%s %s ohdr=v%d chunks=%d hdr_bytes=%llu", path, kind,
+            oi->version, oi->nchunks, oi->bytes);
+    if(links)
+        printf(" links=%s", links);
+
+    if(oi->layout_class >= 0) {
+        static const char *classes[] = {"compact", "contiguous", "chunked", "virtual"};
+
+        printf(" layout=v%d,%s", oi->layout_version,
+                oi->layout_class < 4 ? classes[oi->layout_class] : "?");
+        if(oi->layout_class == 2) {
+            if(oi->chunk_index >= 0) {
+                printf(",%s", chunk_index_names[oi->chunk_index]);
+                c->chunk_index[oi->chunk_index]++;
+            } else
+                printf(",?");
+            if(oi->chunk_index == 0)
+                printf(" nchunks=%lu", oi->nchunks_raw);
+        }
+        if(oi->layout_class != 2 || oi->chunk_index == 0) {
+            printf(" raw_bytes=%llu", oi->raw_bytes);
+            c->raw_bytes += oi->raw_bytes;
+        } else {
+            printf(" raw_bytes=?");
+            c->unknown_raw++;
+        }
+        if(oi->pline_version)
+            printf(" filters=%d(v%d)", oi->nfilters, oi->pline_version);
+        if(oi->fill_version > 0)
+            printf(" fill=v%d", oi->fill_version);
+        if(oi->dspace_version)
+            printf(" dspace=v%d", oi->dspace_version);
+    }
+    if(oi->dtype_shared)
+        printf(" dtype=shared");
+    else if(oi->dtype_version)
+        printf(" dtype=v%d,class%d", oi->dtype_version, oi->dtype_class);
+
+    if(oi->ainfo && !undef_addr(c, oi->attr_fheap)) {
+        printf(" attrs=dense(%llu)", oi->dense_nattrs);
+        c->dense_attr_objects++;
+    } else if(oi->nattrs) {
+        printf(" attrs=compact(%d,v%d)", oi->nattrs, oi->attr_version);
+        c->compact_attrs += (unsigned long)oi->nattrs;
+    }
+    printf("\n");
+}
+
+/* Census of one object, then of everything linked from it */
+static void
+walk(census_t *c, unsigned long long addr, const char *path)
+{
+    obj_info_t oi;
+    link_t *links = NULL;
+    int nlinks = 0, alinks = 0;
+    char linkdesc[64];
+    const char *first;
+    int i;
+
+    if((first = seen(c, addr, path)) != NULL) {
+        printf("%s hard link to %s\n", path, first);
+        return;
+    }
+
+    memset(&oi, 0, sizeof(oi));
+    oi.layout_class = -1;
+    oi.chunk_index = -1;
+    if(ohdr_v1(c, addr, &oi) < 0 && ohdr_v2(c, addr, &oi) < 0) {
+        printf("%s ? unreadable object header at %llu\n", path, addr);
+        c->unknown++;
+        return;
+    }
+
+    /* Byte counts that need more than the header */
+    if(oi.layout_class == 2 && oi.chunk_index == 0 && !undef_addr(c, oi.layout_addr))
+        chunk_btree(c, oi.layout_addr, oi.layout_rank, &oi);
+    if(oi.ainfo && !undef_addr(c, oi.attr_fheap)) {
+        fheap_t fh;
+
+        if(fheap_open(c, oi.attr_fheap, &fh) == 0)
+            oi.dense_nattrs = fh.nobjs;
+        if(!undef_addr(c, oi.attr_name_bt2))
+            bt2_iterate(c, oi.attr_name_bt2, NULL, NULL);
+    }
+
+    /* Gather the links, however they are stored */
+    linkdesc[0] = '\0';
+    if(oi.stab) {
+        const unsigned char *h = at(c, oi.lheap_addr, 8 + 2 * (unsigned long long)c->sizeof_size + c->sizeof_addr);
+
+        if(h && memcmp(h, "HEAP", 4) == 0)
+            stab_btree(c, oi.btree_addr, dec(h + 8 + 2 * c->sizeof_size, c->sizeof_addr),
+                    &links, &nlinks, &alinks);
+        snprintf(linkdesc, sizeof(linkdesc), "symtab(%d)", nlinks);
+        c->symtab_groups++;
+    } else if(oi.linfo && !undef_addr(c, oi.link_fheap)) {
+        fheap_t fh;
+        dense_links_t dl;
+
+        memset(&dl, 0, sizeof(dl));
+        if(fheap_open(c, oi.link_fheap, &fh) == 0) {
+            dl.fh = &fh;
+            bt2_iterate(c, oi.link_name_bt2, dense_link_cb, &dl);
+        }
+        if(!undef_addr(c, oi.link_corder_bt2))
+            bt2_iterate(c, oi.link_corder_bt2, NULL, NULL);
+        links = dl.links;
+        nlinks = dl.n;
+        snprintf(linkdesc, sizeof(linkdesc), "dense(%d%s)", nlinks,
+                undef_addr(c, oi.link_corder_bt2) ? "" : ",crt_order_index");
+        c->dense_groups++;
+    } else if(oi.nlinks || oi.linfo || oi.ginfo) {
+        links = malloc(sizeof(link_t) * (size_t)(oi.nlinks ? oi.nlinks : 1));
+        for(i = 0; i < oi.nlinks; i++)
+            if(decode_link(c, oi.links[i], &links[nlinks]) == 0)
+                nlinks++;
+        snprintf(linkdesc, sizeof(linkdesc), "compact(%d)", nlinks);
+        c->compact_groups++;
+    }
+    free(oi.links);
+
+    report(c, path, &oi, linkdesc[0] ? linkdesc : NULL);
+
+    for(i = 0; i < nlinks; i++) {
+        char child[MAX_PATH];
+
+        snprintf(child, sizeof(child), "%s%s%s", path, strcmp(path, "/") ? "/" : "", links[i].name);
+        if(links[i].type == 0)
+            walk(c, links[i].addr, child);
+        else if(links[i].type == 1)
+            printf("%s soft link to %s\n", child, links[i].value);
+        else if(links[i].type == 64)
+            printf("%s external link to %s\n", child, links[i].value);
+        else
+            printf("%s user-defined link type %d\n", child, links[i].type);
+    }
+    free(links);
+}
+
+int
+main(int argc, char *argv[])
+{
+    census_t c;
+    struct stat st;
+    const unsigned char *sb = NULL;
+    unsigned long long off, eof = 0, root = 0;
+    int fd, sb_version, i;
+
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s <file>\n", argv[0]);
+        return(1);
+    }
+    memset(&c, 0, sizeof(c));
+
+    if((fd = open(argv[1], O_RDONLY)) < 0 || fstat(fd, &st) < 0 || st.st_size < 8) {
+        fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+        return(1);
+    }
+    c.size = (unsigned long long)st.st_size;
+    c.buf = mmap(NULL, (size_t)c.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(c.buf == MAP_FAILED) {
+        fprintf(stderr, "%s: cannot map %s\n", argv[0], argv[1]);
+        return(1);
+    }
+
+    /* The superblock is at 0, 512, 1024, 2048, ... */
+    for(off = 0; off + 8 <= c.size; off = off ? off * 2 : 512)
+        if(memcmp(c.buf + off, "\211HDF\r\n\032\n", 8) == 0) {
+            sb = c.buf + off;
+            break;
+        }
+    if(sb == NULL || off + 64 > c.size) {
+        fprintf(stderr, "%s: no HDF5 superblock in %s\n", argv[0], argv[1]);
+        return(1);
+    }
+
+    sb_version = sb[8];
+    if(sb_version < 2) {
+        const unsigned char *p;
+
+        c.sizeof_addr = sb[13];
+        c.sizeof_size = sb[14];
+        p = sb + 24 + (sb_version == 1 ? 4 : 0);
+        c.base = dec(p, c.sizeof_addr);
+        eof = dec(p + 2 * c.sizeof_addr, c.sizeof_addr);
+        /* Root group symbol table entry: name offset, object header address */
+        root = dec(p + 4 * c.sizeof_addr + c.sizeof_size, c.sizeof_addr);
+        printf("superblock version=%d offset=%llu sizeof_addr=%d sizeof_size=%d freespace=v%d root_stab=v%d shared_hdr=v%d\n",
+                sb_version, off, c.sizeof_addr, c.sizeof_size, sb[9], sb[10], sb[12]);
+    } else {
+        unsigned long long ext;
+
+        c.sizeof_addr = sb[9];
+        c.sizeof_size = sb[10];
+        c.base = dec(sb + 12, c.sizeof_addr);
+        ext = dec(sb + 12 + c.sizeof_addr, c.sizeof_addr);
+        eof = dec(sb + 12 + 2 * c.sizeof_addr, c.sizeof_addr);
+        root = dec(sb + 12 + 3 * c.sizeof_addr, c.sizeof_addr);
+        printf("superblock version=%d offset=%llu sizeof_addr=%d sizeof_size=%d flags=0x%x extension=%s\n",
+                sb_version, off, c.sizeof_addr, c.sizeof_size, sb[11],
+                undef_addr(&c, ext) ? "no" : "yes");
+    }
+    if(c.base == 0)
+        c.base = off;
+
+    walk(&c, root, "/");
+
+    printf("total objects=%lu ohdr_v1=%lu ohdr_v2=%lu hdr_chunks=%lu hdr_bytes=%llu raw_bytes=%llu unknown_raw=%lu\n",
+            c.objects, c.ohdr_v1, c.ohdr_v2, c.hdr_chunks, c.hdr_bytes, c.raw_bytes, c.unknown_raw);
+    printf("total groups symtab=%lu compact=%lu dense=%lu\n",
+            c.symtab_groups, c.compact_groups, c.dense_groups);
+    printf("total attrs compact=%lu dense_objects=%lu shared_mesgs=%lu\n",
+            c.compact_attrs, c.dense_attr_objects, c.shared_mesgs);
+    printf("total fractal_heaps=%lu v2_btrees=%lu", c.fractal_heaps, c.v2_btrees);
+    for(i = 0; i < NINDEX_TYPES; i++)
+        printf(" %s=%lu", chunk_index_names[i], c.chunk_index[i]);
+    printf("\n");
+    printf("total eof=%llu file_size=%llu unknown=%lu\n", eof, c.size, c.unknown);
+
+    return(0);
+}
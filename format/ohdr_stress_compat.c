@@ -0,0 +1,288 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API ohdr_stress_compat.c
+ *
+ *  Rewrite or read the attributes of the files tests/t_ohdr.c creates,
+ *  ohdr_v16.h5 and ohdr_v18.h5.  check_format.sh runs this once per
+ *  library release in turn, twice over, so that the object headers are
+ *  rewritten by every release, and then once more per release to read
+ *  them.
+ *
+ *  Usage:  a.out stress <round>
+ *              Open each file for writing and OHDR_NCYCLES times go over
+ *              every attribute, rewriting it in place, deleting it and
+ *              adding it back with a new length, or deleting it and adding
+ *              it back as it was.
+ *          a.out read
+ *              Open each file read-only, then open every dataset and read
+ *              and check all of its attributes.
+ *
+ *  These go to TIMEPATH:
+ *
+ *      <file>_r<round>_stress  all the cycles, in ms
+ *      <file>_read             mean time to open a dataset and read all of
+ *                              its attributes, in us
+ *
+ *  and from v1.8 on, the object headers' state after each run, summed
+ *  over the datasets (H5Gget_objinfo):
+ *
+ *      <file>[_r<round>]_chunks    object header chunks
+ *      <file>[_r<round>]_messages  object header messages
+ *      <file>[_r<round>]_size      object header bytes
+ *      <file>[_r<round>]_free      object header bytes not in use
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <string.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The objects, as in tests/t_ohdr.c */
+#define OHDR_NOBJS      8
+#define OHDR_NATTRS     20
+#define OHDR_MAXLEN     64
+
+/* Cycles over every attribute per run */
+#ifndef OHDR_NCYCLES
+#define OHDR_NCYCLES    100
+#endif
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Record the state of the object headers, prefixed with what */
+static void
+report_headers(hid_t fid, const char *name, const char *what)
+{
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 8
+    H5G_stat_t statbuf;
+    char oname[32];
+    double chunks = 0.0, nmesgs = 0.0, size = 0.0, free_bytes = 0.0;
+    int n;
+
+    for(n = 0; n < OHDR_NOBJS; n++) {
+        sprintf(oname, "/d%d", n);
+        if(H5Gget_objinfo(fid, oname, 0, &statbuf) < 0)
+            return;
+        chunks += statbuf.ohdr.nchunks;
+        nmesgs += statbuf.ohdr.nmesgs;
+        size += (double)statbuf.ohdr.size;
+        free_bytes += (double)statbuf.ohdr.free;
+    }
+    sprintf(oname, "%schunks", what);
+    compat_timing_file("t_ohdr", name, oname, chunks, "chunks");
+    sprintf(oname, "%smessages", what);
+    compat_timing_file("t_ohdr", name, oname, nmesgs, "messages");
+    sprintf(oname, "%ssize", what);
+    compat_timing_file("t_ohdr", name, oname, size, "bytes");
+    sprintf(oname, "%sfree", what);
+    compat_timing_file("t_ohdr", name, oname, free_bytes, "bytes");
+#endif
+} /* report_headers() */
+
+/* Add attribute aname of len elements to did */
+static int
+add_attr(hid_t did, const char *aname, int k, hsize_t len)
+{
+    hid_t sid, aid;
+    int buf[OHDR_MAXLEN];
+    int j, ret = 0;
+
+    for(j = 0; j < (int)len; j++)
+        buf[j] = k * 1000 + j;
+    sid = H5Screate_simple(1, &len, NULL);
+    if((aid = H5Acreate(did, aname, H5T_NATIVE_INT, sid, H5P_DEFAULT)) < 0)
+        ret = -1;
+    else {
+        if(H5Awrite(aid, H5T_NATIVE_INT, buf) < 0)
+            ret = -1;
+        H5Aclose(aid);
+    }
+    H5Sclose(sid);
+
+    return ret;
+} /* add_attr() */
+
+/* Apply operation op to attribute k of did in cycle c */
+static int
+stress_attr(hid_t did, int k, int c, int op)
+{
+    hid_t aid, sid;
+    hsize_t len;
+    int buf[OHDR_MAXLEN];
+    char aname[32];
+    int j, ret = 0;
+
+    sprintf(aname, "attr%05d", k);
+    if((aid = H5Aopen_name(did, aname)) < 0)
+        return -1;
+    sid = H5Aget_space(aid);
+    len = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    H5Sclose(sid);
+
+    if(op == 0) {
+        /* Rewrite in place */
+        for(j = 0; j < (int)len; j++)
+            buf[j] = k * 1000 + j;
+        ret = H5Awrite(aid, H5T_NATIVE_INT, buf) < 0 ? -1 : 0;
+        H5Aclose(aid);
+    }
+    else {
+        /* Delete, then add back with a new length or as it was */
+        H5Aclose(aid);
+        if(op == 1)
+            len = (hsize_t)(1 + (c * 7 + k * 3) % OHDR_MAXLEN);
+        if(H5Adelete(did, aname) < 0 || add_attr(did, aname, k, len) < 0)
+            ret = -1;
+    }
+
+    return ret;
+} /* stress_attr() */
+
+/* Open file name for writing and run OHDR_NCYCLES cycles over every
+ * attribute */
+int
+stress_file(const char *name, const char *round)
+{
+    hid_t fid, did;
+    char oname[32];
+    double t;
+    int c, n, k, ret = 0;
+
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDWR, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+
+    t = compat_time_now();
+    for(c = 0; c < OHDR_NCYCLES && ret == 0; c++)
+        for(n = 0; n < OHDR_NOBJS && ret == 0; n++) {
+            sprintf(oname, "/d%d", n);
+            if((did = H5Dopen(fid, oname)) < 0) {
+                ret = -1;
+                break;
+            }
+            for(k = 0; k < OHDR_NATTRS && ret == 0; k++)
+                ret = stress_attr(did, k, c, (c + k + n) % 3);
+            H5Dclose(did);
+        }
+    t = compat_time_now() - t;
+
+    if(ret == 0) {
+        sprintf(oname, "r%s_stress", round);
+        compat_timing_file("t_ohdr", name, oname, t * 1000.0, "ms");
+        sprintf(oname, "r%s_", round);
+        report_headers(fid, name, oname);
+    }
+    if(H5Fclose(fid) < 0)
+        ret = -1;
+
+    return ret;
+} /* stress_file() */
+
+/* Open file name read-only and check every attribute */
+int
+read_file(const char *name)
+{
+    hid_t fid, did, aid, sid;
+    int buf[OHDR_MAXLEN];
+    char oname[32];
+    hssize_t len;
+    double t0, elapsed = 0.0;
+    int n, k, j, ret = 0;
+
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+
+    for(n = 0; n < OHDR_NOBJS && ret == 0; n++) {
+        t0 = compat_time_now();
+        sprintf(oname, "/d%d", n);
+        if((did = H5Dopen(fid, oname)) < 0) {
+            ret = -1;
+            break;
+        }
+        if(H5Aget_num_attrs(did) != OHDR_NATTRS)
+            ret = -1;
+        for(k = 0; k < OHDR_NATTRS && ret == 0; k++) {
+            sprintf(oname, "attr%05d", k);
+            if((aid = H5Aopen_name(did, oname)) < 0) {
+                ret = -1;
+                break;
+            }
+            sid = H5Aget_space(aid);
+            len = H5Sget_simple_extent_npoints(sid);
+            H5Sclose(sid);
+            if(len < 1 || len > OHDR_MAXLEN || H5Aread(aid, H5T_NATIVE_INT, buf) < 0)
+                ret = -1;
+            H5Aclose(aid);
+            for(j = 0; j < len && ret == 0; j++)
+                if(buf[j] != k * 1000 + j)
+                    ret = -1;
+        }
+        H5Dclose(did);
+        elapsed += compat_time_now() - t0;
+    }
+
+    if(ret == 0) {
+        compat_timing_file("t_ohdr", name, "read", elapsed / OHDR_NOBJS * 1000000.0, "us");
+        report_headers(fid, name, "");
+    }
+    H5Fclose(fid);
+
+    return ret;
+} /* read_file() */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    const char *names[2] = {"ohdr_v16.h5", "ohdr_v18.h5"};
+    int f;
+
+    if(argc < 2 || (strcmp(argv[1], "read") && (strcmp(argv[1], "stress") || argc < 3))) {
+        fprintf(stderr, "usage: %s stress <round> | read\n", argv[0]);
+        return 1;
+    }
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    for(f = 0; f < 2; f++) {
+        if(!strcmp(argv[1], "stress"))
+            check(stress_file(names[f], argv[2]), "stress", names[f], NULL, fp);
+        else
+            check(read_file(names[f]), "read", names[f], NULL, fp);
+    }
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
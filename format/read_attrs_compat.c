@@ -0,0 +1,179 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_attrs_compat.c
+ *
+ *  Open each dataset tests/t_attrs.c creates, check its attribute count,
+ *  open and read ATTR_NLOOKUPS of its attributes by name and iterate over
+ *  all of them.  v1.6 can open attr_v16.h5 and its /compact_<n> datasets,
+ *  whose attributes all live in the object header, but the /ph<c>_<n>
+ *  datasets next to them have v1.8 object headers; attr_v18.h5 is in the
+ *  v1.8 format.
+ *
+ *  For each dataset these go to TIMEPATH, as <file>_<dset>_<what>:
+ *
+ *      open        H5Dopen(), in us
+ *      nattrs      attributes H5Aget_num_attrs() reports
+ *      lookup      mean time to open and read one attribute by name, in us
+ *      iter        attributes per second, with H5Aiterate()
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The datasets, as in tests/t_attrs.c */
+#ifndef ATTR_MAX
+#define ATTR_MAX        100000
+#endif
+#define ATTR_V16_MAX    10000
+
+/* Attributes looked up per dataset, at most */
+#define ATTR_NLOOKUPS   1000
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Record one metric of dataset dname of file fname */
+static void
+report(const char *fname, const char *dname, const char *what, double value, const char *unit)
+{
+    char dname_what[64];
+
+    sprintf(dname_what, "%s_%s", dname + 1, what);
+    compat_timing_file("t_attrs", fname, dname_what, value, unit);
+} /* report() */
+
+/* H5Aiterate() callback, counting the attributes */
+static herr_t
+count_attr(hid_t loc, const char *name, void *op_data)
+{
+    (*(long *)op_data)++;
+
+    return 0;
+} /* count_attr() */
+
+/* Open dataset dname of file fname, which should have n attributes, then
+ * look up and iterate over them */
+int
+read_dset(hid_t fid, const char *fname, const char *dname, long n)
+{
+    hid_t did, aid;
+    char aname[32];
+    unsigned idx = 0;
+    long i, nlookups, count = 0;
+    int nattrs, value, ret = 0;
+    double t;
+
+    t = compat_time_now();
+    H5E_BEGIN_TRY {
+        did = H5Dopen(fid, dname);
+    } H5E_END_TRY;
+    if(did < 0)
+        return -1;
+    report(fname, dname, "open", (compat_time_now() - t) * 1000000.0, "us");
+
+    nattrs = H5Aget_num_attrs(did);
+    report(fname, dname, "nattrs", (double)nattrs, "attrs");
+    if(nattrs != n)
+        ret = -1;
+
+    /* Look up attributes spread over the dataset */
+    nlookups = n < ATTR_NLOOKUPS ? n : ATTR_NLOOKUPS;
+    t = compat_time_now();
+    for(i = 0; i < nlookups && ret == 0; i++) {
+        sprintf(aname, "attr%06ld", i * (n / nlookups));
+        if((aid = H5Aopen_name(did, aname)) < 0) {
+            ret = -1;
+            break;
+        }
+        if(H5Aread(aid, H5T_NATIVE_INT, &value) < 0 || value != i * (n / nlookups))
+            ret = -1;
+        H5Aclose(aid);
+    }
+    t = compat_time_now() - t;
+    if(ret == 0)
+        report(fname, dname, "lookup", t / nlookups * 1000000.0, "us");
+
+    if(ret == 0) {
+        t = compat_time_now();
+        if(H5Aiterate(did, &idx, count_attr, &count) < 0 || count != n)
+            ret = -1;
+        t = compat_time_now() - t;
+        if(ret == 0)
+            report(fname, dname, "iter", t > 0.0 ? n / t : 0.0, "attrs/s");
+    }
+
+    H5Dclose(did);
+
+    return ret;
+} /* read_dset() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+    unsigned max_compact[3] = {0, 8, 1000};
+    char dname[32];
+    long n;
+    int p;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    H5E_BEGIN_TRY {
+        fid = H5Fopen("attr_v16.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(check(fid < 0 ? -1 : 0, "file", "attr_v16.h5", NULL, fp) >= 0) {
+        for(n = 1000; n <= ATTR_V16_MAX; n *= 10) {
+            sprintf(dname, "/compact_%ld", n);
+            check(read_dset(fid, "attr_v16.h5", dname, n), "attrs", dname, NULL, fp);
+        }
+        for(p = 0; p < 3; p++)
+            for(n = 1000; n <= ATTR_V16_MAX; n *= 10) {
+                sprintf(dname, "/ph%u_%ld", max_compact[p], n);
+                check(read_dset(fid, "attr_v16.h5", dname, n), "attrs", dname, "(creation order)", fp);
+            }
+        H5Fclose(fid);
+    }
+
+    H5E_BEGIN_TRY {
+        fid = H5Fopen("attr_v18.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(check(fid < 0 ? -1 : 0, "file", "attr_v18.h5", NULL, fp) >= 0) {
+        for(p = 0; p < 3; p++)
+            for(n = 1000; n <= ATTR_MAX; n *= 10) {
+                sprintf(dname, "/ph%u_%ld", max_compact[p], n);
+                check(read_dset(fid, "attr_v18.h5", dname, n), "attrs", dname, NULL, fp);
+            }
+        H5Fclose(fid);
+    }
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,176 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_chunk_compat.c
+ *
+ *  Read the datasets tests/t_chunk_index.c adds to compat.h5, one per chunk
+ *  index type.  For each, check that it opens, then read it whole and read
+ *  a BLOCK x BLOCK corner of every chunk, and check the values.  The
+ *  partial read touches every chunk but only a little of each, so its
+ *  time is mostly spent looking chunks up in the index.
+ *
+ *  Read throughput for each dataset goes to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+#define FILENAME "compat.h5"
+
+#define CHUNK_GROUP "/chunk_index"
+
+/* Elements read from each chunk by the partial read, in each dimension */
+#define BLOCK 4
+
+/* The datasets, in the order tests/t_chunk_index.c writes them */
+static const char *dset_names[] = {
+    "btree1", "single", "implicit", "farray", "earray", "btree2"
+};
+#define NDSETS (sizeof(dset_names) / sizeof(dset_names[0]))
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Read the whole dataset and check every element */
+int
+full_read(hid_t did, hsize_t n, int *buf, double *seconds)
+{
+    hsize_t k;
+    int bad = 0;
+
+    *seconds = compat_time_now();
+    if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+        return -1;
+    *seconds = compat_time_now() - *seconds;
+
+    for(k = 0; k < n * n; k++)
+        bad |= buf[k] != (int)k;
+
+    return bad ? -1 : 0;
+} /* full_read() */
+
+/* Read a BLOCK x BLOCK corner of every chunk and check it */
+int
+partial_read(hid_t did, hsize_t n, hsize_t cdim, int *buf, double *nbytes, double *seconds)
+{
+    hid_t sid, mid;
+    hsize_t start[2], stride[2], count[2], block[2], mdims[2];
+    hsize_t nb, i, j, r, c;
+    int bad = 0;
+
+    nb = cdim < BLOCK ? cdim : BLOCK;
+    start[0] = start[1] = 0;
+    stride[0] = stride[1] = cdim;
+    count[0] = count[1] = n / cdim;
+    block[0] = block[1] = nb;
+    mdims[0] = mdims[1] = count[0] * nb;
+
+    sid = H5Dget_space(did);
+    H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, stride, count, block);
+    mid = H5Screate_simple(2, mdims, NULL);
+
+    *seconds = compat_time_now();
+    if(H5Dread(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, buf) < 0)
+        bad = 1;
+    *seconds = compat_time_now() - *seconds;
+    *nbytes = (double)(mdims[0] * mdims[1] * sizeof(int));
+
+    H5Sclose(mid);
+    H5Sclose(sid);
+
+    /* Memory (i, j) holds file (i / nb * cdim + i % nb, likewise for j) */
+    for(i = 0; i < mdims[0] && !bad; i++) {
+        r = i / nb * cdim + i % nb;
+        for(j = 0; j < mdims[1]; j++) {
+            c = j / nb * cdim + j % nb;
+            bad |= buf[i * mdims[1] + j] != (int)(r * n + c);
+        }
+    }
+
+    return bad ? -1 : 0;
+} /* partial_read() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+    hid_t did;          /* Dataset ID */
+    hid_t sid, dcpl;
+    hsize_t dims[2], cdims[2];
+    char name[64], metric[64];
+    double nbytes, t;
+    int *buf;
+    unsigned u;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    for(u = 0; u < NDSETS; u++) {
+        sprintf(name, "%s/%s", CHUNK_GROUP, dset_names[u]);
+
+        H5E_BEGIN_TRY {
+            did = H5Dopen(fid, name);
+        } H5E_END_TRY;
+        if(check(did < 0 ? -1 : 0, "chunk_index", name, "(open)", fp) < 0)
+            continue;
+
+        /* The size and chunking come from the file */
+        sid = H5Dget_space(did);
+        H5Sget_simple_extent_dims(sid, dims, NULL);
+        H5Sclose(sid);
+        dcpl = H5Dget_create_plist(did);
+        H5Pget_chunk(dcpl, 2, cdims);
+        H5Pclose(dcpl);
+
+        buf = (int *)malloc((size_t)(dims[0] * dims[1] * sizeof(int)));
+
+        check(full_read(did, dims[0], buf, &t), "chunk_index", name, "(full read)", fp);
+        sprintf(metric, "%s_full_read", dset_names[u]);
+        compat_timing("t_chunk_index", metric, compat_mbps((double)(dims[0] * dims[1] * sizeof(int)), t), "MB/s");
+
+        check(partial_read(did, dims[0], cdims[0], buf, &nbytes, &t), "chunk_index", name, "(partial read)", fp);
+        sprintf(metric, "%s_partial_read", dset_names[u]);
+        compat_timing("t_chunk_index", metric, compat_mbps(nbytes, t), "MB/s");
+        sprintf(metric, "%s_partial_chunks", dset_names[u]);
+        compat_timing("t_chunk_index", metric, t > 0.0 ? (double)(dims[0] / cdims[0]) * (double)(dims[1] / cdims[1]) / t : 0.0, "chunks/s");
+
+        free(buf);
+        H5Dclose(did);
+    }
+
+    H5Fclose(fid);
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -15,6 +15,7 @@
 #include "hdf5.h"
 #include <string.h>
 #include <stdio.h>
+#include "compat_dset1.h"
 
 #define FILEPATH "./errors.log"
 #define FILENAME "compat.h5"
@@ -83,50 +84,18 @@ int check_dset1(hid_t *did, hid_t gid2, const char *link_name)
     return 0;
 }
 
-/* data in dset2 */
+/* data in dset1 */
 
 int check_data1(hid_t did)
 {
-    typedef struct { /* compound type has members with rank > 1 */
-      int a[2][2][2][2]; /* arrays are 2x2x2x2    */
-      double b[2][2][2][2];
-      double c[2][2][2][2];
-    } dset1_t;
-    dset1_t buf[6];
-
-    int j, i0, i1, i2, i3;
-    int idx[4] = {0,1,2,3};
-    const int perm[4] = {0,1,2,3};
-    hsize_t sdim = 6;
     hid_t tid;
+    hssize_t ret;
 
     if((tid = H5Dget_type(did)) <0) return -1;
-    H5Dread(did, tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
-
-    for (j=0; j<(int)sdim; j++) {
-      for (i3 = 0; i3 < 2; i3++) {
-        idx[perm[3]] = i3;
-        for (i2 = 0; i2 < 2; i2++) {
-          idx[perm[2]] = i2;
-          for (i1 = 0; i1 < 2; i1++) {
-            idx[perm[1]] = i1;
-            for (i0 = 0; i0 < 2; i0++) {
-              idx[perm[0]] = i0;
-
-                if(buf[j].a[idx[3]][idx[2]][idx[1]][idx[0]] != i0+j) return -1;
-                if(buf[j].b[idx[3]][idx[2]][idx[1]][idx[0]] != (double)(i0+j)) return -1;
-              #ifdef WIN32
-                if(buf[j].c[idx[3]][idx[2]][idx[1]][idx[0]] != (double)(i0+j+(signed __int64)sdim)) return -1;
-              #else
-                if(buf[j].c[idx[3]][idx[2]][idx[1]][idx[0]] != (double)(i0+j+sdim)) return -1;
-              #endif
-            }
-          }
-        }
-      }
-    }
+    ret = dset1_read_verify(did, tid);
+    H5Tclose(tid);
 
-    return 0;
+    return ret < 0 ? -1 : 0;
 }
 
 
@@ -0,0 +1,299 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_compound_compat.c
+ *
+ *  Read the dset1 compound dataset tests/t_compound.c adds to compat.h5
+ *  into each of these memory types, and check every value:
+ *
+ *      native      dset1_t itself, so no conversion is needed
+ *      reordered   the members in the order c, a, b
+ *      subset      b_array only
+ *      float       a_array as int, b_array and c_array as float
+ *      swapped     dset1_t with the opposite byte order
+ *
+ *  The H5Dread() time of each goes to TIMEPATH, as MB/s of dataset data.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "compat_timing.h"
+#include "compat_dset1.h"
+
+#define FILEPATH "./errors.log"
+#define FILENAME "compat.h5"
+
+#define COMPOUND_DSET "/compound/dset1"
+
+/* The memory types, besides dset1_t */
+typedef struct {
+    double c[DSET1_NVALS];
+    int a[DSET1_NVALS];
+    double b[DSET1_NVALS];
+} reordered_t;
+
+typedef struct {
+    double b[DSET1_NVALS];
+} subset_t;
+
+typedef struct {
+    int a[DSET1_NVALS];
+    float b[DSET1_NVALS];
+    float c[DSET1_NVALS];
+} downcast_t;
+
+/* Verify count elements from element first of a total-element dataset;
+ * the buffer may be overwritten */
+typedef int (*verify_func_t)(void *buf, hsize_t first, size_t count, hsize_t total);
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Insert a 2x2x2x2 array member of base type base_id */
+static void
+insert_array(hid_t tid, const char *name, size_t offset, hid_t base_id)
+{
+    hid_t array_dt;
+    hsize_t dim[4];
+
+    dim[0] = dim[1] = dim[2] = dim[3] = 2;
+    array_dt = dset1_array_create(base_id, 4, dim);
+    H5Tinsert(tid, name, offset, array_dt);
+    H5Tclose(array_dt);
+} /* insert_array() */
+
+/* Swap the bytes of each size-byte value in the n values at buf */
+static void
+swap_bytes(void *buf, size_t size, size_t n)
+{
+    unsigned char *p = (unsigned char *)buf, tmp;
+    size_t k, i;
+
+    for(k = 0; k < n; k++, p += size)
+        for(i = 0; i < size / 2; i++) {
+            tmp = p[i];
+            p[i] = p[size - 1 - i];
+            p[size - 1 - i] = tmp;
+        }
+} /* swap_bytes() */
+
+static int
+verify_native(void *buf, hsize_t first, size_t count, hsize_t total)
+{
+    return dset1_verify((const dset1_t *)buf, first, count, total);
+} /* verify_native() */
+
+static int
+verify_reordered(void *buf, hsize_t first, size_t count, hsize_t total)
+{
+    const reordered_t *r = (const reordered_t *)buf;
+    size_t k;
+    int n, bad = 0;
+
+    for(k = 0; k < count && !bad; k++)
+        for(n = 0; n < DSET1_NVALS; n++)
+            bad |= (r[k].a[n] != dset1_i0[n] + (int)(first + k))
+                 | (r[k].b[n] != (double)dset1_i0[n] + (double)(first + k))
+                 | (r[k].c[n] != (double)dset1_i0[n] + (double)(first + k + total));
+
+    return bad ? -1 : 0;
+} /* verify_reordered() */
+
+static int
+verify_subset(void *buf, hsize_t first, size_t count, hsize_t total)
+{
+    const subset_t *s = (const subset_t *)buf;
+    size_t k;
+    int n, bad = 0;
+
+    for(k = 0; k < count && !bad; k++)
+        for(n = 0; n < DSET1_NVALS; n++)
+            bad |= s[k].b[n] != (double)dset1_i0[n] + (double)(first + k);
+
+    return bad ? -1 : 0;
+} /* verify_subset() */
+
+/* The values are integers below 2^24, so float holds them exactly */
+static int
+verify_float(void *buf, hsize_t first, size_t count, hsize_t total)
+{
+    const downcast_t *f = (const downcast_t *)buf;
+    size_t k;
+    int n, bad = 0;
+
+    for(k = 0; k < count && !bad; k++)
+        for(n = 0; n < DSET1_NVALS; n++)
+            bad |= (f[k].a[n] != dset1_i0[n] + (int)(first + k))
+                 | (f[k].b[n] != (float)(dset1_i0[n] + (double)(first + k)))
+                 | (f[k].c[n] != (float)(dset1_i0[n] + (double)(first + k + total)));
+
+    return bad ? -1 : 0;
+} /* verify_float() */
+
+/* Swap back in place, then compare */
+static int
+verify_swapped(void *buf, hsize_t first, size_t count, hsize_t total)
+{
+    dset1_t *d = (dset1_t *)buf;
+    size_t k;
+
+    for(k = 0; k < count; k++) {
+        swap_bytes(d[k].a, sizeof(int), (size_t)DSET1_NVALS);
+        swap_bytes(d[k].b, sizeof(double), (size_t)DSET1_NVALS);
+        swap_bytes(d[k].c, sizeof(double), (size_t)DSET1_NVALS);
+    }
+
+    return dset1_verify(d, first, count, total);
+} /* verify_swapped() */
+
+/* Read all of did into mem_tid DSET1_SLAB elements at a time, timing only
+ * the H5Dread() calls, and verify every value */
+int
+read_variant(hid_t did, const char *variant, hid_t mem_tid, verify_func_t verify)
+{
+    hid_t sid, mid, ftid;
+    hsize_t nelmts, start, count;
+    size_t mem_size;
+    char metric[64];
+    void *buf;
+    double t, elapsed = 0.0, fbytes;
+    int ret = 0;
+
+    sid = H5Dget_space(did);
+    nelmts = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    ftid = H5Dget_type(did);
+    fbytes = (double)nelmts * (double)H5Tget_size(ftid);
+    H5Tclose(ftid);
+
+    mem_size = H5Tget_size(mem_tid);
+    count = nelmts < DSET1_SLAB ? nelmts : DSET1_SLAB;
+    if((buf = malloc(mem_size * (size_t)(count ? count : 1))) == NULL) {
+        H5Sclose(sid);
+        return -1;
+    }
+
+    for(start = 0; start < nelmts && ret == 0; start += count) {
+        count = nelmts - start < DSET1_SLAB ? nelmts - start : DSET1_SLAB;
+        mid = H5Screate_simple(1, &count, NULL);
+        H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, NULL, &count, NULL);
+        t = compat_time_now();
+        if(H5Dread(did, mem_tid, mid, sid, H5P_DEFAULT, buf) < 0)
+            ret = -1;
+        elapsed += compat_time_now() - t;
+        if(ret == 0)
+            ret = verify(buf, start, (size_t)count, nelmts);
+        H5Sclose(mid);
+    }
+    H5Sclose(sid);
+    free(buf);
+
+    if(ret == 0) {
+        sprintf(metric, "%s_read", variant);
+        compat_timing("t_compound", metric, compat_mbps(fbytes, elapsed), "MB/s");
+    }
+
+    return ret;
+} /* read_variant() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+    hid_t did;          /* Dataset ID */
+    hid_t tid;          /* Memory datatype ID */
+    hid_t swap_int, swap_double;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    H5E_BEGIN_TRY {
+        did = H5Dopen(fid, COMPOUND_DSET);
+    } H5E_END_TRY;
+    if(check(did < 0 ? -1 : 0, "dset", COMPOUND_DSET, NULL, fp) < 0) {
+        H5Fclose(fid);
+        fclose(fp);
+        return 0;
+    }
+
+    /* No conversion */
+    tid = dset1_create_type();
+    check(read_variant(did, "native", tid, verify_native), "compound", "native", NULL, fp);
+    H5Tclose(tid);
+
+    /* Members in another order */
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(reordered_t));
+    insert_array(tid, "c_array", HOFFSET(reordered_t, c), H5T_NATIVE_DOUBLE);
+    insert_array(tid, "a_array", HOFFSET(reordered_t, a), H5T_NATIVE_INT);
+    insert_array(tid, "b_array", HOFFSET(reordered_t, b), H5T_NATIVE_DOUBLE);
+    check(read_variant(did, "reordered", tid, verify_reordered), "compound", "reordered", NULL, fp);
+    H5Tclose(tid);
+
+    /* One member */
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(subset_t));
+    insert_array(tid, "b_array", HOFFSET(subset_t, b), H5T_NATIVE_DOUBLE);
+    check(read_variant(did, "subset", tid, verify_subset), "compound", "subset", NULL, fp);
+    H5Tclose(tid);
+
+    /* double members converted to float */
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(downcast_t));
+    insert_array(tid, "a_array", HOFFSET(downcast_t, a), H5T_NATIVE_INT);
+    insert_array(tid, "b_array", HOFFSET(downcast_t, b), H5T_NATIVE_FLOAT);
+    insert_array(tid, "c_array", HOFFSET(downcast_t, c), H5T_NATIVE_FLOAT);
+    check(read_variant(did, "float", tid, verify_float), "compound", "float", NULL, fp);
+    H5Tclose(tid);
+
+    /* The same layout with every value byte-swapped */
+    swap_int = H5Tcopy(H5T_NATIVE_INT);
+    swap_double = H5Tcopy(H5T_NATIVE_DOUBLE);
+    if(H5Tget_order(H5T_NATIVE_INT) == H5T_ORDER_LE) {
+        H5Tset_order(swap_int, H5T_ORDER_BE);
+        H5Tset_order(swap_double, H5T_ORDER_BE);
+    }
+    else {
+        H5Tset_order(swap_int, H5T_ORDER_LE);
+        H5Tset_order(swap_double, H5T_ORDER_LE);
+    }
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(dset1_t));
+    insert_array(tid, "a_array", HOFFSET(dset1_t, a), swap_int);
+    insert_array(tid, "b_array", HOFFSET(dset1_t, b), swap_double);
+    insert_array(tid, "c_array", HOFFSET(dset1_t, c), swap_double);
+    check(read_variant(did, "swapped", tid, verify_swapped), "compound", "swapped", NULL, fp);
+    H5Tclose(tid);
+    H5Tclose(swap_int);
+    H5Tclose(swap_double);
+
+    H5Dclose(did);
+    H5Fclose(fid);
+    fclose(fp);
+
+    return 0;
+} /* main() */
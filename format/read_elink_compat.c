@@ -0,0 +1,158 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_elink_compat.c
+ *
+ *  Open group g6, which tests/t_elink.c adds to compat.h5, and read every
+ *  dataset its external links point to, in the order they were created,
+ *  which moves to another of the ELINK_NFILES sibling files at every link.
+ *  This is done once with the default file access properties and, from
+ *  v1.8.7 on, once with an external link file cache big enough for every
+ *  sibling file (H5Pset_elink_file_cache_size), so that each is opened
+ *  once instead of once per link.  v1.6 cannot open g6, which holds link
+ *  messages.
+ *
+ *  For each way of reading these go to TIMEPATH:
+ *
+ *      <how>_traverse  links followed per second
+ *      <how>_first     H5Fopen() and the first link, in ms
+ *
+ *  where <how> is nocache or cache.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+#define FILENAME "compat.h5"
+
+/* The files and links, as in tests/t_elink.c */
+#ifndef ELINK_NFILES
+#define ELINK_NFILES    64
+#endif
+#define ELINK_PER_FILE  16
+#define ELINK_NELMTS    16
+
+/* H5Pset_elink_file_cache_size() appeared in v1.8.7 */
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR > 8 || (H5_VERS_MINOR == 8 && H5_VERS_RELEASE >= 7)
+#define HAVE_ELINK_CACHE
+#endif
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Open compat.h5 with fapl, then follow and check every link of g6 */
+int
+traverse(hid_t fapl, const char *how)
+{
+    hid_t fid, gid, did;
+    int buf[ELINK_NELMTS];
+    char lname[32], metric[64];
+    double t0, t;
+    int i, j, k, ret = 0;
+
+    t0 = compat_time_now();
+    if((fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, fapl)) < 0)
+        return -1;
+    if((gid = H5Gopen(fid, "/g6")) < 0) {
+        H5Fclose(fid);
+        return -1;
+    }
+
+    t = t0;
+    for(j = 0; j < ELINK_PER_FILE && ret == 0; j++)
+        for(i = 0; i < ELINK_NFILES && ret == 0; i++) {
+            sprintf(lname, "e%d_%d", i, j);
+            if((did = H5Dopen(gid, lname)) < 0) {
+                ret = -1;
+                break;
+            }
+            if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+                ret = -1;
+            H5Dclose(did);
+            for(k = 0; k < ELINK_NELMTS && ret == 0; k++)
+                if(buf[k] != i * 1000 + j * 10 + k)
+                    ret = -1;
+            if(i == 0 && j == 0) {
+                t = compat_time_now();
+                sprintf(metric, "%s_first", how);
+                compat_timing("t_elink", metric, (t - t0) * 1000.0, "ms");
+            }
+        }
+    t = compat_time_now() - t;
+
+    H5Gclose(gid);
+    H5Fclose(fid);
+
+    if(ret == 0) {
+        sprintf(metric, "%s_traverse", how);
+        compat_timing("t_elink", metric,
+                t > 0.0 ? (ELINK_NFILES * ELINK_PER_FILE - 1) / t : 0.0, "links/s");
+    }
+
+    return ret;
+} /* traverse() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+    hid_t gid;          /* Group ID */
+#ifdef HAVE_ELINK_CACHE
+    hid_t fapl;         /* File access property list */
+#endif
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+    H5E_BEGIN_TRY {
+        gid = H5Gopen(fid, "/g6");
+    } H5E_END_TRY;
+    H5Fclose(fid);
+    if(check(gid < 0 ? -1 : 0, "group", "/g6", NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+    H5Gclose(gid);
+
+    check(traverse(H5P_DEFAULT, "nocache"), "elink", "/g6", "(no file cache)", fp);
+
+#ifdef HAVE_ELINK_CACHE
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_elink_file_cache_size(fapl, ELINK_NFILES);
+    check(traverse(fapl, "cache"), "elink", "/g6", "(file cache)", fp);
+    H5Pclose(fapl);
+#endif
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
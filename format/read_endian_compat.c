@@ -0,0 +1,167 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_endian_compat.c
+ *
+ *  Read every dataset of endian_compat.h5, from gen_endian_compat.c, into
+ *  the native type of the same width and check every value.  The datasets
+ *  in the host's byte order need no conversion and give the baseline for
+ *  the byte-swapped ones.  The H5Dread() rate of each, in MB/s of file
+ *  data, goes to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+#define FILENAME "endian_compat.h5"
+
+/* The values, as in gen_endian_compat.c */
+#define ENDIAN_INT(k)   ((long long)((k) % 32749) - 16374)
+#define ENDIAN_FLOAT(k) ((double)ENDIAN_INT(k) / 8.0)
+#define ENDIAN_SCALE16  1LL
+#define ENDIAN_SCALE32  65537LL
+#define ENDIAN_SCALE64  (65537LL * 65537LL * 65537LL)
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Compare nelmts values of native type mtid with the generator pattern */
+int
+check_values(const void *buf, hid_t mtid, hsize_t nelmts)
+{
+    hsize_t k;
+    int bad = 0;
+
+    if(H5Tget_class(mtid) == H5T_FLOAT) {
+        if(H5Tget_size(mtid) == sizeof(float)) {
+            const float *f = (const float *)buf;
+            for(k = 0; k < nelmts && !bad; k++)
+                bad = f[k] != (float)ENDIAN_FLOAT(k);
+        }
+        else {
+            const double *d = (const double *)buf;
+            for(k = 0; k < nelmts && !bad; k++)
+                bad = d[k] != ENDIAN_FLOAT(k);
+        }
+    }
+    else if(H5Tget_size(mtid) == sizeof(short)) {
+        const short *s = (const short *)buf;
+        for(k = 0; k < nelmts && !bad; k++)
+            bad = s[k] != (short)(ENDIAN_INT(k) * ENDIAN_SCALE16);
+    }
+    else if(H5Tget_size(mtid) == sizeof(int)) {
+        const int *i = (const int *)buf;
+        for(k = 0; k < nelmts && !bad; k++)
+            bad = i[k] != (int)(ENDIAN_INT(k) * ENDIAN_SCALE32);
+    }
+    else {
+        const long long *l = (const long long *)buf;
+        for(k = 0; k < nelmts && !bad; k++)
+            bad = l[k] != ENDIAN_INT(k) * ENDIAN_SCALE64;
+    }
+
+    return bad ? -1 : 0;
+} /* check_values() */
+
+/* Read dataset name into mtid, check it and time the read */
+int
+read_dset(hid_t fid, const char *name, hid_t mtid)
+{
+    hid_t did, sid, ftid;
+    hsize_t nelmts;
+    char metric[64];
+    void *buf;
+    double t, fbytes;
+    int ret = 0;
+
+    H5E_BEGIN_TRY {
+        did = H5Dopen(fid, name);
+    } H5E_END_TRY;
+    if(did < 0)
+        return -1;
+
+    sid = H5Dget_space(did);
+    nelmts = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    H5Sclose(sid);
+    ftid = H5Dget_type(did);
+    fbytes = (double)nelmts * (double)H5Tget_size(ftid);
+    H5Tclose(ftid);
+
+    if((buf = malloc((size_t)nelmts * H5Tget_size(mtid) + 1)) == NULL) {
+        H5Dclose(did);
+        return -1;
+    }
+
+    t = compat_time_now();
+    if(H5Dread(did, mtid, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+        ret = -1;
+    t = compat_time_now() - t;
+    H5Dclose(did);
+
+    if(ret == 0)
+        ret = check_values(buf, mtid, nelmts);
+    free(buf);
+
+    if(ret == 0) {
+        sprintf(metric, "%s_read", name);
+        compat_timing("t_endian", metric, compat_mbps(fbytes, t), "MB/s");
+    }
+
+    return ret;
+} /* read_dset() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    check(read_dset(fid, "i16le", H5T_NATIVE_SHORT), "endian", "i16le", NULL, fp);
+    check(read_dset(fid, "i16be", H5T_NATIVE_SHORT), "endian", "i16be", NULL, fp);
+    check(read_dset(fid, "i32le", H5T_NATIVE_INT), "endian", "i32le", NULL, fp);
+    check(read_dset(fid, "i32be", H5T_NATIVE_INT), "endian", "i32be", NULL, fp);
+    check(read_dset(fid, "i64le", H5T_NATIVE_LLONG), "endian", "i64le", NULL, fp);
+    check(read_dset(fid, "i64be", H5T_NATIVE_LLONG), "endian", "i64be", NULL, fp);
+    check(read_dset(fid, "f32le", H5T_NATIVE_FLOAT), "endian", "f32le", NULL, fp);
+    check(read_dset(fid, "f32be", H5T_NATIVE_FLOAT), "endian", "f32be", NULL, fp);
+    check(read_dset(fid, "f64le", H5T_NATIVE_DOUBLE), "endian", "f64le", NULL, fp);
+    check(read_dset(fid, "f64be", H5T_NATIVE_DOUBLE), "endian", "f64be", NULL, fp);
+
+    H5Fclose(fid);
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,160 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_fill_compat.c
+ *
+ *  Read /data whole from each file tests/t_fill.c creates, into a buffer
+ *  first set to FILL_SENTINEL.  The written part must hold element i = i.
+ *  Where the fill value is written at allocation (fill time alloc, or
+ *  ifset with the fill value set, as here), the rest must hold FILL_VALUE.
+ *  With fill time never, what the rest reads as is left to the library and
+ *  the storage, so it is only recorded.
+ *
+ *  For each file these go to TIMEPATH:
+ *
+ *      <file>_read         MB/s
+ *      <file>_unwritten    what the unwritten part read as, with fill time
+ *                          never: 0 zeros, 1 the fill value, 2 the buffer
+ *                          left as it was, 3 anything else
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The datasets, as in tests/t_fill.c */
+#ifndef FILL_NELMTS
+#define FILL_NELMTS         4194304
+#endif
+#define FILL_WRITTEN_PART   16
+#define FILL_VALUE          (-1)
+
+/* Set in the read buffer beforehand, to show what a read leaves alone */
+#define FILL_SENTINEL       0x5a5a5a5a
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Classify the unwritten part of buf: 0 zeros, 1 the fill value, 2 the
+ * sentinel, 3 anything else */
+static int
+unwritten_kind(const int *buf)
+{
+    int kinds[3] = {0, FILL_VALUE, FILL_SENTINEL};
+    long i;
+    int k;
+
+    for(k = 0; k < 3; k++) {
+        for(i = FILL_NELMTS / FILL_WRITTEN_PART; i < FILL_NELMTS; i++)
+            if(buf[i] != kinds[k])
+                break;
+        if(i == FILL_NELMTS)
+            return k;
+    }
+
+    return 3;
+} /* unwritten_kind() */
+
+/* Read and check /data of file name; buf holds FILL_NELMTS integers */
+int
+read_file(const char *name, int *buf)
+{
+    hid_t fid, did;
+    double t;
+    long i;
+    int must_fill, ret = 0;
+
+    must_fill = strstr(name, "_never") == NULL;
+    for(i = 0; i < FILL_NELMTS; i++)
+        buf[i] = FILL_SENTINEL;
+
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+    if((did = H5Dopen(fid, "/data")) < 0) {
+        H5Fclose(fid);
+        return -1;
+    }
+
+    t = compat_time_now();
+    if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+        ret = -1;
+    t = compat_time_now() - t;
+    H5Dclose(did);
+    H5Fclose(fid);
+
+    for(i = 0; i < FILL_NELMTS / FILL_WRITTEN_PART && ret == 0; i++)
+        if(buf[i] != (int)i)
+            ret = -1;
+    if(ret == 0) {
+        if(must_fill) {
+            if(unwritten_kind(buf) != 1)
+                ret = -1;
+        }
+        else
+            compat_timing_file("t_fill", name, "unwritten", (double)unwritten_kind(buf), "kind");
+    }
+    if(ret == 0)
+        compat_timing_file("t_fill", name, "read", compat_mbps((double)FILL_NELMTS * sizeof(int), t), "MB/s");
+
+    return ret;
+} /* read_file() */
+
+int main(void)
+{
+    FILE *fp;
+    const char *layouts[2] = {"contig", "chunk"};
+    const char *allocs[3] = {"early", "incr", "late"};
+    const char *fills[3] = {"alloc", "never", "ifset"};
+    char name[64];
+    int *buf;
+    int l, a, f;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    if((buf = (int *)malloc(sizeof(int) * FILL_NELMTS)) == NULL) {
+        fclose(fp);
+        return 1;
+    }
+
+    for(l = 0; l < 2; l++)
+        for(a = 0; a < 3; a++)
+            for(f = 0; f < 3; f++) {
+                sprintf(name, "fill_%s_%s_%s.h5", layouts[l], allocs[a], fills[f]);
+                check(read_file(name, buf), "fill", name, NULL, fp);
+            }
+
+    free(buf);
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,138 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_filter_compat.c
+ *
+ *  Read the filtered datasets tests/t_filters.c adds to compat.h5 and check
+ *  every value.  A dataset passes only if it opens, reads and holds the
+ *  right data, so a library without one of the filters (v1.6 has neither
+ *  n-bit nor scale-offset) reports an error for that dataset.
+ *
+ *  Whether a library has szip depends on how it was built, not on its
+ *  version, so the szip dataset is left out of errors.log.  Its result goes
+ *  to TIMEPATH with the decode throughput of every dataset.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+#define FILENAME "compat.h5"
+
+#define FILTER_GROUP "/filters"
+
+/* The value of element k, as in tests/t_filters.c */
+#define FILTER_VALUE(k) ((int)(((k) / 16) % 262144))
+
+/* The datasets, in the order tests/t_filters.c writes them */
+static const char *dset_names[] = {
+    "deflate", "shuffle_deflate", "fletcher32", "nbit", "scaleoffset"
+};
+#define NDSETS (sizeof(dset_names) / sizeof(dset_names[0]))
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Open, read and verify one dataset, and time the read */
+int
+read_dset(hid_t fid, const char *dname)
+{
+    hid_t did, sid;
+    hsize_t nelmts, k;
+    char name[64], metric[64];
+    int *buf;
+    int bad = 0;
+    double t;
+
+    sprintf(name, "%s/%s", FILTER_GROUP, dname);
+    H5E_BEGIN_TRY {
+        did = H5Dopen(fid, name);
+    } H5E_END_TRY;
+    if(did < 0)
+        return -1;
+
+    sid = H5Dget_space(did);
+    nelmts = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    H5Sclose(sid);
+    if((buf = (int *)malloc((size_t)nelmts * sizeof(int))) == NULL) {
+        H5Dclose(did);
+        return -1;
+    }
+
+    t = compat_time_now();
+    H5E_BEGIN_TRY {
+        if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+            bad = 1;
+    } H5E_END_TRY;
+    t = compat_time_now() - t;
+    H5Dclose(did);
+
+    for(k = 0; k < nelmts && !bad; k++)
+        bad |= buf[k] != FILTER_VALUE(k);
+    free(buf);
+
+    if(!bad) {
+        sprintf(metric, "%s_decode", dname);
+        compat_timing("t_filters", metric, compat_mbps((double)nelmts * sizeof(int), t), "MB/s");
+    }
+
+    return bad ? -1 : 0;
+} /* read_dset() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+    hid_t did;
+    unsigned u;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    for(u = 0; u < NDSETS; u++)
+        check(read_dset(fid, dset_names[u]), "filter", dset_names[u], NULL, fp);
+
+    /* szip, if the writer could encode it */
+    H5E_BEGIN_TRY {
+        did = H5Dopen(fid, FILTER_GROUP "/szip");
+    } H5E_END_TRY;
+    if(did >= 0) {
+        H5Dclose(did);
+        compat_timing("t_filters", "szip_decoded", read_dset(fid, "szip") < 0 ? 0.0 : 1.0, "bool");
+    }
+
+    H5Fclose(fid);
+    fclose(fp);
+
+    return 0;
+} /* main() */
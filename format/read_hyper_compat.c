@@ -20,6 +20,10 @@
  *  when accessing the dataset region references via H5Rget_region().
  *
  *  See gen_hyper_compat.c and tests/t_hyper.c.
+ *
+ *  The same references are also read from the <dataset>_scale datasets,
+ *  HYPER_NREFS copies each, and the rate at which H5Rget_region() decodes
+ *  them goes to TIMEPATH.
  */
 
 #include "hdf5.h"
@@ -27,6 +31,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
+#include "compat_timing.h"
 
 /* The error log file */
 #define FILEPATH    "./errors.log" 
@@ -167,6 +172,77 @@ check_dataspace(hid_t fid, char *dname, unsigned in_rel, FILE *fp)
 
 } /* check_dataspace() */
 
+/*
+ *  Decode every reference in <dname>_scale and time it.  The expected
+ *  result is the one check_dataspace() expects for dname: every reference
+ *  decodes, with the selection of the first, if this release is in_rel or
+ *  later, and none does otherwise.
+ */
+int
+check_scale(hid_t fid, const char *dname, unsigned in_rel, FILE *fp)
+{
+    hid_t sid = -1;             /* Dataspace ID */
+    hid_t did = -1;             /* Dataset ID */
+    hdset_reg_ref_t *ref_rbuf;  /* The buffer for the references */
+    hssize_t nrefs;             /* Number of references */
+    hssize_t npoints = -1;      /* Elements selected by the first */
+    hssize_t k;
+    char name[64];
+    char metric[64];
+    unsigned minor;             /* Library release versions */
+    int ndecoded = 0, nsame = 0;
+    double t;
+
+    /* Get library release version */
+    H5get_libversion(NULL, &minor, NULL);
+
+    sprintf(name, "%s_scale", dname);
+    if(H5Lexists(fid, name, H5P_DEFAULT) != TRUE) {
+        check(0, "Dataset does not exist", name, "Correct", fp);
+        return(0);
+    }
+
+    /* Read all of the references */
+    did = H5Dopen2(fid, name, H5P_DEFAULT);
+    sid = H5Dget_space(did);
+    nrefs = H5Sget_simple_extent_npoints(sid);
+    H5Sclose(sid);
+    ref_rbuf = calloc(sizeof(hdset_reg_ref_t), (size_t)nrefs);
+    H5Dread(did, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_rbuf);
+
+    /* Decode them */
+    t = compat_time_now();
+    for(k = 0; k < nrefs; k++) {
+        H5E_BEGIN_TRY {
+            sid = H5Rget_region(did, H5R_DATASET_REGION, &ref_rbuf[k]);
+        } H5E_END_TRY;
+        if(sid >= 0) {
+            if(npoints < 0)
+                npoints = H5Sget_select_npoints(sid);
+            nsame += H5Sget_select_npoints(sid) == npoints;
+            ndecoded++;
+            H5Sclose(sid);
+        }
+    }
+    t = compat_time_now() - t;
+
+    if(ndecoded == nrefs) {
+        sprintf(metric, "%s_get_region", dname);
+        compat_timing("t_hyper", metric, t > 0.0 ? (double)nrefs / t : 0.0, "refs/s");
+    }
+
+    if(minor >= in_rel)
+        check(ndecoded == nrefs && nsame == nrefs ? 0 : -1, "Decoding all region references", name, NULL, fp);
+    else
+        check(ndecoded == 0 ? 0 : -1, "Fail to decode all region references", name, "Correct", fp);
+
+    H5Dclose(did);
+    free(ref_rbuf);
+
+    return(0);
+
+} /* check_scale() */
+
 int main(void)
 {
     FILE *fp;           /* Pointer to log file */
@@ -188,6 +264,14 @@ int main(void)
     check_dataspace(fid, ADD_REF_X_IRR_DSET, LIB_REL_V12, fp);
     check_dataspace(fid, ADD_REF_X_PT_DSET, LIB_REL_V12, fp);
 
+    /* Decode the scaled copies */
+    check_scale(fid, REF_NX_REG_DSET, 0, fp);
+    check_scale(fid, REF_NX_IRR_DSET, 0, fp);
+    check_scale(fid, REF_NX_PT_DSET, 0, fp);
+    check_scale(fid, ADD_REF_X_REG_DSET, LIB_REL_V10, fp);
+    check_scale(fid, ADD_REF_X_IRR_DSET, LIB_REL_V12, fp);
+    check_scale(fid, ADD_REF_X_PT_DSET, LIB_REL_V12, fp);
+
     /* Close the file */
     H5Fclose(fid);
 
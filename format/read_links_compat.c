@@ -0,0 +1,237 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_links_compat.c
+ *
+ *  Open each group tests/t_links.c creates in links_v16.h5 and
+ *  links_v18.h5, look up LINKS_NLOOKUPS of its links by name and iterate
+ *  over all of them in name order, checking that each comes in the right
+ *  place.  From v1.8 on the /crt_<n> groups are also iterated in creation
+ *  order (H5Literate with H5_INDEX_CRT_ORDER).  v1.6 can open links_v16.h5
+ *  but only its symbol table groups, not the /crt_<n> groups next to them
+ *  that hold link messages, and cannot open links_v18.h5.
+ *
+ *  errors.log gets one line per group, so the expected output is for the
+ *  default LINKS_MAX.
+ *
+ *  For each group these go to TIMEPATH:
+ *
+ *      <group>_open        H5Gopen(), in us
+ *      <group>_lookup      lookups per second, with H5Gget_objinfo()
+ *      <group>_iter_name   links per second, in name order (H5Giterate)
+ *      <group>_iter_crt    links per second, in creation order
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The groups, as in tests/t_links.c */
+#ifndef LINKS_MAX
+#define LINKS_MAX           100000
+#endif
+#define LINKS_STRIDE        7919
+
+/* Links looked up per group, at most */
+#define LINKS_NLOOKUPS      1000
+
+/* What an iteration has seen */
+typedef struct {
+    long n;         /* Links in the group */
+    long next;      /* Position of the next link */
+    int by_crt;     /* Whether links come in creation order */
+    int bad;        /* Set when a link is out of place */
+} iter_info_t;
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Record one metric of group gname */
+static void
+report(const char *gname, const char *what, double value, const char *unit)
+{
+    char metric[64];
+
+    sprintf(metric, "%s_%s", gname + 1, what);
+    compat_timing("t_links", metric, value, unit);
+} /* report() */
+
+/* Check that link name comes next */
+static void
+check_next(iter_info_t *info, const char *name)
+{
+    char expected[32];
+    long m;
+
+    m = info->by_crt ? info->next * LINKS_STRIDE % info->n : info->next;
+    sprintf(expected, "l%07ld", m);
+    if(info->next >= info->n || strcmp(name, expected))
+        info->bad = 1;
+    info->next++;
+} /* check_next() */
+
+/* H5Giterate() callback */
+static herr_t
+iter_name(hid_t gid, const char *name, void *op_data)
+{
+    check_next((iter_info_t *)op_data, name);
+
+    return 0;
+} /* iter_name() */
+
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 8
+/* H5Literate() callback */
+static herr_t
+iter_crt(hid_t gid, const char *name, const H5L_info_t *linfo, void *op_data)
+{
+    check_next((iter_info_t *)op_data, name);
+
+    return 0;
+} /* iter_crt() */
+
+/* Iterate over group gid in creation order */
+int
+read_crt_order(hid_t gid, const char *gname, long n)
+{
+    iter_info_t info;
+    hsize_t idx = 0;
+    double t;
+
+    info.n = n;
+    info.next = 0;
+    info.by_crt = 1;
+    info.bad = 0;
+    t = compat_time_now();
+    if(H5Literate(gid, H5_INDEX_CRT_ORDER, H5_ITER_INC, &idx, iter_crt, &info) < 0)
+        return -1;
+    t = compat_time_now() - t;
+    if(info.bad || info.next != n)
+        return -1;
+    report(gname, "iter_crt", t > 0.0 ? n / t : 0.0, "links/s");
+
+    return 0;
+} /* read_crt_order() */
+#endif
+
+/* Open group gname of n links, look up some of its links and iterate
+ * over all of them in name order */
+int
+read_group(hid_t fid, const char *gname, long n)
+{
+    hid_t gid;
+    H5G_stat_t statbuf;
+    iter_info_t info;
+    char lname[32];
+    long k, nlookups;
+    int idx = 0, ret = 0;
+    double t;
+
+    t = compat_time_now();
+    H5E_BEGIN_TRY {
+        gid = H5Gopen(fid, gname);
+    } H5E_END_TRY;
+    if(gid < 0)
+        return -1;
+    report(gname, "open", (compat_time_now() - t) * 1000000.0, "us");
+
+    /* Look up links spread over the group */
+    nlookups = n < LINKS_NLOOKUPS ? n : LINKS_NLOOKUPS;
+    t = compat_time_now();
+    for(k = 0; k < nlookups && ret == 0; k++) {
+        sprintf(lname, "l%07ld", k * (n / nlookups));
+        if(H5Gget_objinfo(gid, lname, 0, &statbuf) < 0 || statbuf.type != H5G_LINK)
+            ret = -1;
+    }
+    t = compat_time_now() - t;
+    if(ret == 0)
+        report(gname, "lookup", t > 0.0 ? nlookups / t : 0.0, "lookups/s");
+
+    if(ret == 0) {
+        info.n = n;
+        info.next = 0;
+        info.by_crt = 0;
+        info.bad = 0;
+        t = compat_time_now();
+        if(H5Giterate(gid, ".", &idx, iter_name, &info) < 0 || info.bad || info.next != n)
+            ret = -1;
+        t = compat_time_now() - t;
+        if(ret == 0)
+            report(gname, "iter_name", t > 0.0 ? n / t : 0.0, "links/s");
+    }
+
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 8
+    if(ret == 0 && !strncmp(gname, "/crt_", 5))
+        ret = read_crt_order(gid, gname, n);
+#endif
+
+    H5Gclose(gid);
+
+    return ret;
+} /* read_group() */
+
+/* Open file name and read its groups of each kind */
+void
+read_file(const char *name, const char **kinds, int nkinds, FILE *fp)
+{
+    hid_t fid;          /* File ID */
+    char gname[32];
+    long n;
+    int i;
+
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(check(fid < 0 ? -1 : 0, "file", name, NULL, fp) < 0)
+        return;
+
+    for(n = 10; n <= LINKS_MAX; n *= 10)
+        for(i = 0; i < nkinds; i++) {
+            sprintf(gname, "/%s_%ld", kinds[i], n);
+            check(read_group(fid, gname, n), "links", gname, NULL, fp);
+        }
+
+    H5Fclose(fid);
+} /* read_file() */
+
+int main(void)
+{
+    FILE *fp;
+    const char *kinds_v16[2] = {"symtab", "crt"};
+    const char *kinds_v18[1] = {"name"};
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    read_file("links_v16.h5", kinds_v16, 2, fp);
+    read_file("links_v18.h5", kinds_v18, 1, fp);
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,258 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_lock_compat.c
+ *
+ *  Fork NREADERS reader processes against compat.h5 while tests/t_lock.c
+ *  holds it open for writing.  Each reader retries H5Fopen() until it
+ *  succeeds or LOCK_TIMEOUT expires, then reads dset1 and dset2
+ *  READ_PASSES times.  The writer rewrites dset2 while it holds the file,
+ *  so every read must find either the values gen_compat.c wrote or the
+ *  ones tests/t_lock.c wrote, never a mix; a reader whose first open was
+ *  refused only got in after the writer closed the file, and must find
+ *  the new values.
+ *
+ *  Usage:  a.out <log file> [nolock]
+ *      <log file>  receives the Passed/Error lines.  check_format.sh runs
+ *                  one of these programs per library release at the same
+ *                  time, so each needs its own log; they are collated into
+ *                  errors.log afterwards.
+ *      nolock      also turn file locking off with H5Pset_file_locking()
+ *                  in the libraries that have it (v1.10.7+, v1.12.1+).
+ *
+ *  The log also records how many readers had their first open refused.
+ *  Failed opens, lock wait time and read throughput go to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "compat_timing.h"
+#include "compat_dset1.h"
+
+#define FILENAME "compat.h5"
+
+#define NREADERS        8           /* Reader processes per library release */
+#define READ_PASSES     100         /* Times each reader reads the datasets */
+#define LOCK_TIMEOUT    60.0        /* Seconds a reader keeps retrying */
+#define LOCK_RETRY_USEC 10000       /* Microseconds between open attempts */
+
+/* Added to every value of dset2 by the writer, as in tests/t_lock.c */
+#define LOCK_DSET2_NEW  1000
+
+/* What read_data() found in dset2 */
+#define LOCK_OLD_IMAGE  0
+#define LOCK_NEW_IMAGE  1
+
+/* H5Pset_file_locking() appeared in v1.10.7 and v1.12.1 */
+#if (H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 7) || (H5_VERS_MINOR == 12 && H5_VERS_RELEASE >= 1) || H5_VERS_MINOR > 12
+#define HAVE_FILE_LOCKING_API
+#endif
+
+/* What one reader process reports back to the parent */
+typedef struct {
+    int opened;             /* H5Fopen() eventually succeeded */
+    int data_ok;            /* Every read found a whole old or new image */
+    int failed_opens;       /* H5Fopen() attempts that failed */
+    double wait;            /* Seconds from the first attempt to the open */
+    double read_time;       /* Seconds spent reading */
+    double nbytes;          /* Bytes read */
+} lock_result_t;
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Read dset1 and dset2 once; return LOCK_OLD_IMAGE if dset2 holds what
+ * gen_compat.c wrote, LOCK_NEW_IMAGE if it holds what tests/t_lock.c
+ * wrote, and -1 for anything else */
+int
+read_data(hid_t fid, double *nbytes)
+{
+    int buf2[10][10];
+    hid_t did, tid;
+    hssize_t nelmts;
+    int image, i, j;
+
+    /* dset1 */
+    if((did = H5Dopen(fid, "/g1/g1.1/dset1")) < 0) return -1;
+    tid = H5Dget_type(did);
+    nelmts = dset1_read_verify(did, tid);
+    H5Tclose(tid);
+    H5Dclose(did);
+    if(nelmts < 0) return -1;
+    *nbytes += (double)nelmts * (double)sizeof(dset1_t);
+
+    /* dset2 */
+    if((did = H5Dopen(fid, "/g4/dset2")) < 0) return -1;
+    if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf2) < 0) {
+        H5Dclose(did);
+        return -1;
+    }
+    H5Dclose(did);
+    *nbytes += (double)sizeof(buf2);
+
+    image = buf2[0][0] == LOCK_DSET2_NEW ? LOCK_NEW_IMAGE : LOCK_OLD_IMAGE;
+    for (i = 0; i < 10; i++)
+        for (j = 0; j < 10; j++)
+            if(buf2[i][j] != (image == LOCK_NEW_IMAGE ? LOCK_DSET2_NEW : 0) + j + 10 * i)
+                return -1;
+
+    return image;
+} /* read_data() */
+
+/* One reader process: open with retries, then read */
+void
+run_reader(int nolock, lock_result_t *res)
+{
+    hid_t fid = -1;     /* File ID */
+    hid_t fapl;         /* File access property list */
+    double start, t;
+    int image, pass;
+
+    memset(res, 0, sizeof(lock_result_t));
+
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+#ifdef HAVE_FILE_LOCKING_API
+    if(nolock)
+        H5Pset_file_locking(fapl, 0, 1);
+#endif
+
+    start = compat_time_now();
+    H5E_BEGIN_TRY {
+        while((fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, fapl)) < 0) {
+            res->failed_opens++;
+            if(compat_time_now() - start > LOCK_TIMEOUT)
+                break;
+            usleep(LOCK_RETRY_USEC);
+        }
+    } H5E_END_TRY;
+    res->wait = compat_time_now() - start;
+    H5Pclose(fapl);
+
+    if(fid < 0)
+        return;
+    res->opened = 1;
+
+    res->data_ok = 1;
+    t = compat_time_now();
+    for (pass = 0; pass < READ_PASSES; pass++) {
+        image = read_data(fid, &res->nbytes);
+        if(image < 0 || (res->failed_opens > 0 && image != LOCK_NEW_IMAGE))
+            res->data_ok = 0;
+    }
+    res->read_time = compat_time_now() - t;
+
+    H5Fclose(fid);
+} /* run_reader() */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    lock_result_t res[NREADERS];
+    int pfd[2];             /* Pipe the readers report through */
+    pid_t pid;
+    int nolock = 0;
+    int opened = 0, data_ok = 0, blocked = 0, failed = 0;
+    double max_wait = 0.0, sum_wait = 0.0, nbytes = 0.0, read_time = 0.0;
+    char message[64];
+    const char *test;
+    int i;
+
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s <log file> [nolock]\n", argv[0]);
+        return 1;
+    }
+    if(argc > 2 && !strcmp(argv[2], "nolock"))
+        nolock = 1;
+    test = nolock ? "t_lock-nolock" : "t_lock";
+
+    /* Start the readers; the library is not touched before fork() */
+    if(pipe(pfd) < 0)
+        return 1;
+    for (i = 0; i < NREADERS; i++) {
+        if((pid = fork()) < 0)
+            return 1;
+        if(pid == 0) {
+            lock_result_t r;
+
+            close(pfd[0]);
+            run_reader(nolock, &r);
+            write(pfd[1], &r, sizeof(r));
+            _exit(0);
+        }
+    }
+    close(pfd[1]);
+
+    /* Collect the results */
+    memset(res, 0, sizeof(res));
+    for (i = 0; i < NREADERS; i++)
+        if(read(pfd[0], &res[i], sizeof(lock_result_t)) != sizeof(lock_result_t))
+            break;
+    close(pfd[0]);
+    while(wait(NULL) > 0)
+        ;
+
+    for (i = 0; i < NREADERS; i++) {
+        opened += res[i].opened;
+        data_ok += res[i].data_ok;
+        failed += res[i].failed_opens;
+        if(res[i].failed_opens > 0)
+            blocked++;
+        if(res[i].wait > max_wait)
+            max_wait = res[i].wait;
+        sum_wait += res[i].wait;
+        nbytes += res[i].nbytes;
+        read_time += res[i].read_time;
+    }
+
+    /* Only the outcome goes to the log; how long it took varies */
+    if((fp = fopen(argv[1], "a")) == NULL)
+        return 1;
+    sprintf(message, "(%d concurrent readers)", NREADERS);
+    check(opened == NREADERS ? 0 : -1, "lock", "open", message, fp);
+    if(blocked == 0)
+        sprintf(message, "(no reader refused)");
+    else if(blocked == NREADERS)
+        sprintf(message, "(every reader refused)");
+    else
+        sprintf(message, "(%d of %d readers refused)", blocked, NREADERS);
+    check(0, "lock", "first_open", message, fp);
+    sprintf(message, "(%d concurrent readers)", NREADERS);
+    check(data_ok == NREADERS ? 0 : -1, "lock", "data", message, fp);
+    fclose(fp);
+
+    compat_timing(test, "readers", (double)NREADERS, "procs");
+    compat_timing(test, "blocked_readers", (double)blocked, "procs");
+    compat_timing(test, "failed_opens", (double)failed, "calls");
+    compat_timing(test, "lock_wait_max", max_wait, "s");
+    compat_timing(test, "lock_wait_mean", sum_wait / NREADERS, "s");
+    compat_timing(test, "read_throughput", compat_mbps(nbytes, read_time / NREADERS), "MB/s");
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_mdc_image_compat.c
+ *
+ *  Open mdci_plain.h5 and mdci_image.h5 from tests/t_mdc_image.c read-only,
+ *  then visit every group and dataset and check the data.  Each file is
+ *  read by its own child process, so neither open pays for initializing
+ *  the library on behalf of the other and the metadata cache starts cold;
+ *  for mdci_image.h5 it is loaded from the cache image by the libraries
+ *  that know it.
+ *
+ *  For each file these go to TIMEPATH:
+ *
+ *      <file>_open         H5Fopen(), in ms
+ *      <file>_traverse     opening and reading every object, in ms
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The objects, as in tests/t_mdc_image.c */
+#ifndef MDCI_NGROUPS
+#define MDCI_NGROUPS    64
+#endif
+#define MDCI_NDSETS     64
+#define MDCI_NELMTS     16
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Open file name, then open, read and check every object in it */
+int
+read_file(const char *name)
+{
+    hid_t fid, gid, did;
+    int buf[MDCI_NELMTS];
+    char oname[32];
+    double t0, t;
+    int i, j, k, ret = 0;
+
+    t0 = compat_time_now();
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+    t = compat_time_now();
+    compat_timing_file("t_mdc_image", name, "open", (t - t0) * 1000.0, "ms");
+
+    for(i = 0; i < MDCI_NGROUPS && ret == 0; i++) {
+        sprintf(oname, "/g%d", i);
+        if((gid = H5Gopen(fid, oname)) < 0) {
+            ret = -1;
+            break;
+        }
+        for(j = 0; j < MDCI_NDSETS && ret == 0; j++) {
+            sprintf(oname, "d%d", j);
+            if((did = H5Dopen(gid, oname)) < 0) {
+                ret = -1;
+                break;
+            }
+            if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+                ret = -1;
+            H5Dclose(did);
+            for(k = 0; k < MDCI_NELMTS && ret == 0; k++)
+                if(buf[k] != i + j + k)
+                    ret = -1;
+        }
+        H5Gclose(gid);
+    }
+    H5Fclose(fid);
+
+    if(ret == 0)
+        compat_timing_file("t_mdc_image", name, "traverse", (compat_time_now() - t) * 1000.0, "ms");
+
+    return ret;
+} /* read_file() */
+
+/* Read name in a child process; the library is not touched before fork() */
+int
+read_forked(const char *name)
+{
+    pid_t pid;
+    int status;
+
+    if((pid = fork()) < 0)
+        return -1;
+    if(pid == 0)
+        _exit(read_file(name) < 0 ? 1 : 0);
+    if(waitpid(pid, &status, 0) != pid)
+        return -1;
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+} /* read_forked() */
+
+int main(void)
+{
+    FILE *fp;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    check(read_forked("mdci_plain.h5"), "mdc_image", "mdci_plain.h5", NULL, fp);
+    check(read_forked("mdci_image.h5"), "mdc_image", "mdci_image.h5", NULL, fp);
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,199 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_paged_compat.c
+ *
+ *  Open each file tests/t_paged.c creates, then open, read and check every
+ *  dataset in it.  From v1.10.1 on, the paged files are read a second time
+ *  with a page buffer of PAGED_BUFFER bytes (H5Pset_page_buffer_size).
+ *  Every file is opened and closed once untimed first, so the library is
+ *  initialized and the first timed open pays no more than the others.
+ *
+ *  For each file and way of reading it these go to TIMEPATH:
+ *
+ *      <file>_<how>_open       H5Fopen(), in ms
+ *      <file>_<how>_read       opening and reading every dataset, in ms
+ *      <file>_<how>_syscalls   read system calls, from /proc/self/io
+ *      <file>_<how>_bytes      bytes read, from /proc/self/io
+ *
+ *  where <how> is nopb or pb.  The system call counts are only recorded on
+ *  systems with /proc/self/io.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The datasets, as in tests/t_paged.c */
+#ifndef PAGED_NDSETS
+#define PAGED_NDSETS    512
+#endif
+#define PAGED_NELMTS    256
+
+/* Page buffer size, a multiple of every page size used */
+#define PAGED_BUFFER    (4 * 1024 * 1024)
+
+/* H5Pset_page_buffer_size() appeared in v1.10.1 */
+#if H5_VERS_MAJOR > 1 || (H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 1) || H5_VERS_MINOR > 10
+#define HAVE_PAGE_BUFFER
+#endif
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Get the read system calls and bytes read so far; -1 without /proc */
+int
+get_io(double *syscalls, double *bytes)
+{
+    FILE *io;
+    char line[128];
+    int found = 0;
+
+    if((io = fopen("/proc/self/io", "r")) == NULL)
+        return -1;
+    while(fgets(line, (int)sizeof(line), io) != NULL) {
+        if(!strncmp(line, "syscr:", 6)) {
+            *syscalls = atof(line + 6);
+            found++;
+        }
+        else if(!strncmp(line, "rchar:", 6)) {
+            *bytes = atof(line + 6);
+            found++;
+        }
+    }
+    fclose(io);
+
+    return found == 2 ? 0 : -1;
+} /* get_io() */
+
+/* Record one metric of file name read the way how */
+static void
+report(const char *name, const char *how, const char *what, double value, const char *unit)
+{
+    char how_what[64];
+
+    sprintf(how_what, "%s_%s", how, what);
+    compat_timing_file("t_paged", name, how_what, value, unit);
+} /* report() */
+
+/* Open file name with fapl, read and check every dataset */
+int
+read_file(const char *name, hid_t fapl, const char *how)
+{
+    hid_t fid, did;
+    int buf[PAGED_NELMTS];
+    char dname[32];
+    double t0, t, sc0 = 0.0, sc = 0.0, b0 = 0.0, b = 0.0;
+    int have_io, n, i, ret = 0;
+
+    have_io = get_io(&sc0, &b0) == 0;
+    t0 = compat_time_now();
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDONLY, fapl);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+    t = compat_time_now();
+    report(name, how, "open", (t - t0) * 1000.0, "ms");
+
+    for(n = 0; n < PAGED_NDSETS && ret == 0; n++) {
+        sprintf(dname, "/d%d", n);
+        if((did = H5Dopen(fid, dname)) < 0) {
+            ret = -1;
+            break;
+        }
+        if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+            ret = -1;
+        H5Dclose(did);
+        for(i = 0; i < PAGED_NELMTS && ret == 0; i++)
+            if(buf[i] != n * PAGED_NELMTS + i)
+                ret = -1;
+    }
+    H5Fclose(fid);
+
+    if(ret == 0) {
+        report(name, how, "read", (compat_time_now() - t) * 1000.0, "ms");
+        if(have_io && get_io(&sc, &b) == 0) {
+            report(name, how, "syscalls", sc - sc0, "calls");
+            report(name, how, "bytes", b - b0, "bytes");
+        }
+    }
+
+    return ret;
+} /* read_file() */
+
+/* Initialize the library and open and close each file once, untimed */
+void
+warm_up(const char *names[], int nnames)
+{
+    hid_t fid;
+    int f;
+
+    H5open();
+    for(f = 0; f < nnames; f++) {
+        H5E_BEGIN_TRY {
+            fid = H5Fopen(names[f], H5F_ACC_RDONLY, H5P_DEFAULT);
+        } H5E_END_TRY;
+        if(fid >= 0)
+            H5Fclose(fid);
+    }
+} /* warm_up() */
+
+int main(void)
+{
+    FILE *fp;
+    const char *names[4] = {"paged_aggr.h5", "paged_4k.h5", "paged_64k.h5", "paged_1m.h5"};
+#ifdef HAVE_PAGE_BUFFER
+    hid_t fapl;
+#endif
+    int f;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    warm_up(names, 4);
+
+    for(f = 0; f < 4; f++) {
+        check(read_file(names[f], H5P_DEFAULT, "nopb"), "paged", names[f], "(no page buffer)", fp);
+
+#ifdef HAVE_PAGE_BUFFER
+        /* A page buffer can only be used with a paged file */
+        if(f > 0) {
+            fapl = H5Pcreate(H5P_FILE_ACCESS);
+            H5Pset_page_buffer_size(fapl, (size_t)PAGED_BUFFER, 0, 0);
+            check(read_file(names[f], fapl, "pb"), "paged", names[f], "(page buffer)", fp);
+            H5Pclose(fapl);
+        }
+#endif
+    }
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,240 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_raw_compat.c
+ *
+ *  Check the raw data of a contiguous integer dataset without H5Dread():
+ *  ask the library for the dataset's file offset (H5Dget_offset) and
+ *  storage size, mmap() the file and compare the bytes found there with
+ *  the generator pattern, where element k holds the value k.  That is
+ *  dset2 in gen_compat.c and RAW_DSET in gen_raw_compat.c.  The data is
+ *  then read once more with H5Dread() for comparison.
+ *
+ *  Usage:  a.out <file> <dataset> <label>
+ *      <label>     names this check in the timing results, such as the
+ *                  modifying test that was run on the file.
+ *      baseline    given as <label>, only record the dataset's offset in
+ *                  RAW_BASELINE, so that a later run can tell whether a
+ *                  modifying test moved the data.
+ *
+ *  These go to TIMEPATH:
+ *
+ *      <label>_offset          the dataset's file offset
+ *      <label>_relocated       1 if it differs from the baseline, else 0
+ *      <label>_mmap_verify     MB/s checked through mmap()
+ *      <label>_h5dread_verify  MB/s checked through H5Dread()
+ */
+
+#include "hdf5.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"         /* The error log file */
+#define RAW_BASELINE "./raw_baseline.txt"  /* Offsets before modification */
+
+#ifndef HADDR_UNDEF
+#define HADDR_UNDEF ((haddr_t)(-1))
+#endif
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Record one metric of the check named label */
+static void
+report(const char *label, const char *what, double value, const char *unit)
+{
+    char metric[128];
+
+    sprintf(metric, "%.64s_%s", label, what);
+    compat_timing("t_raw", metric, value, unit);
+} /* report() */
+
+/* Compare nelmts 4-byte integers at p with the pattern, swapping if told to */
+int
+check_pattern(const unsigned char *p, hsize_t nelmts, int swap)
+{
+    unsigned v;
+    hsize_t k;
+
+    for(k = 0; k < nelmts; k++, p += 4) {
+        if(swap)
+            v = (unsigned)p[0] << 24 | (unsigned)p[1] << 16 | (unsigned)p[2] << 8 | (unsigned)p[3];
+        else
+            memcpy(&v, p, 4);
+        if(v != (unsigned)k)
+            return -1;
+    }
+
+    return 0;
+} /* check_pattern() */
+
+/* Return the offset recorded by an earlier baseline run, or HADDR_UNDEF */
+haddr_t
+baseline_offset(const char *file, const char *dname)
+{
+    FILE *bp;
+    char bfile[256], bdset[256];
+    unsigned long long off;
+    haddr_t ret = HADDR_UNDEF;
+
+    if((bp = fopen(RAW_BASELINE, "r")) == NULL)
+        return ret;
+    while(fscanf(bp, "%255s %255s %llu", bfile, bdset, &off) == 3)
+        if(!strcmp(bfile, file) && !strcmp(bdset, dname))
+            ret = (haddr_t)off;
+    fclose(bp);
+
+    return ret;
+} /* baseline_offset() */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    hid_t fid = -1;         /* File ID */
+    hid_t did = -1;         /* Dataset ID */
+    hid_t sid, tid, dcpl;
+    const char *file, *dname, *label;
+    haddr_t offset, base;
+    hsize_t storage, nelmts;
+    H5D_layout_t layout;
+    int baseline = 0;
+    int swap, ok;
+    int fd;
+    long page;
+    off_t map_start;
+    size_t map_len;
+    unsigned char *map;
+    int *buf;
+    double t, nbytes;
+
+    if(argc < 4) {
+        fprintf(stderr, "usage: %s <file> <dataset> <label>|baseline\n", argv[0]);
+        return 1;
+    }
+    file = argv[1];
+    dname = argv[2];
+    label = argv[3];
+    if(!strcmp(label, "baseline"))
+        baseline = 1;
+
+    /* Open the error log file */
+    fp = fopen(baseline ? "/dev/null" : FILEPATH, "a");
+
+    H5E_BEGIN_TRY {
+        if((fid = H5Fopen(file, H5F_ACC_RDONLY, H5P_DEFAULT)) >= 0)
+            did = H5Dopen(fid, dname);
+    } H5E_END_TRY;
+    if(check(did < 0 ? -1 : 0, "dset", dname, NULL, fp) < 0) {
+        if(fid >= 0)
+            H5Fclose(fid);
+        fclose(fp);
+        return 0;
+    }
+
+    /* Where the library says the data is */
+    sid = H5Dget_space(did);
+    nelmts = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    H5Sclose(sid);
+    tid = H5Dget_type(did);
+    dcpl = H5Dget_create_plist(did);
+    layout = H5Pget_layout(dcpl);
+    H5Pclose(dcpl);
+    offset = H5Dget_offset(did);
+    storage = H5Dget_storage_size(did);
+    swap = H5Tget_order(tid) != H5Tget_order(H5T_NATIVE_INT);
+
+    ok = (layout == H5D_CONTIGUOUS && offset != HADDR_UNDEF
+            && H5Tget_class(tid) == H5T_INTEGER && H5Tget_size(tid) == 4
+            && storage == nelmts * 4);
+    H5Tclose(tid);
+
+    if(baseline) {
+        FILE *bp;
+
+        if(ok && (bp = fopen(RAW_BASELINE, "a")) != NULL) {
+            fprintf(bp, "%s %s %llu\n", file, dname, (unsigned long long)offset);
+            fclose(bp);
+        }
+        H5Dclose(did);
+        H5Fclose(fid);
+        fclose(fp);
+        return 0;
+    }
+
+    if(check(ok ? 0 : -1, "offset", dname, "(contiguous 4-byte integers)", fp) < 0) {
+        H5Dclose(did);
+        H5Fclose(fid);
+        fclose(fp);
+        return 0;
+    }
+    nbytes = (double)storage;
+
+    /* Did a modifying test move the data? */
+    base = baseline_offset(file, dname);
+    report(label, "offset", (double)offset, "bytes");
+    if(base != HADDR_UNDEF)
+        report(label, "relocated", base != offset ? 1.0 : 0.0, "bool");
+
+    /* Map the file at the dataset's offset and check the bytes directly */
+    ok = -1;
+    t = compat_time_now();
+    if((fd = open(file, O_RDONLY)) >= 0) {
+        page = sysconf(_SC_PAGESIZE);
+        map_start = (off_t)(offset - offset % (haddr_t)page);
+        map_len = (size_t)(offset - (haddr_t)map_start + storage);
+        map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, map_start);
+        if(map != MAP_FAILED) {
+            ok = check_pattern(map + (offset - (haddr_t)map_start), nelmts, swap);
+            munmap(map, map_len);
+        }
+        close(fd);
+    }
+    t = compat_time_now() - t;
+    check(ok, "raw", dname, "(mapped from file)", fp);
+    report(label, "mmap_verify", compat_mbps(nbytes, t), "MB/s");
+
+    /* The same check through H5Dread(), for comparison */
+    ok = -1;
+    if((buf = malloc((size_t)storage)) != NULL) {
+        t = compat_time_now();
+        if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) >= 0)
+            ok = check_pattern((const unsigned char *)buf, nelmts, 0);
+        t = compat_time_now() - t;
+        report(label, "h5dread_verify", compat_mbps(nbytes, t), "MB/s");
+        free(buf);
+    }
+    check(ok, "data", dname, NULL, fp);
+
+    H5Dclose(did);
+    H5Fclose(fid);
+    fclose(fp);
+
+    return 0;
+} /* main() */
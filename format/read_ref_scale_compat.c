@@ -0,0 +1,373 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_ref_scale_compat.c
+ *
+ *  Read back the references tests/t_ref_scale.c adds to ref_compat.h5 and
+ *  time every way this library has to follow them:
+ *
+ *      old_object      H5Rdereference()
+ *      old_region      H5Rdereference() and H5Rget_region()
+ *
+ *  This file is built with H5_USE_16_API, so H5Rdereference() is always
+ *  H5Rdereference1().  With release 1.10 and later both old types are also
+ *  followed with H5Rdereference2(), recorded as <dset>_dereference2.
+ *
+ *  and with release 1.12 and later, reading the same datasets as H5R_ref_t:
+ *
+ *      old_object, revised_object      H5Ropen_object()
+ *      old_region, revised_region      H5Ropen_object() and H5Ropen_region()
+ *
+ *  Every reference is followed in the timed loops.  The objects and
+ *  selections are then checked for every REF_CHECK_STRIDE'th reference.
+ *  Rates go to TIMEPATH, for the loops that followed every reference.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"     /* The error log file */
+#define FILENAME "ref_compat.h5"    /* The test file */
+
+#define REF_GROUP "/Refs"
+
+/* As in tests/t_ref_scale.c */
+#define REF_NTARGETS        64
+#define REF_TARGET_NELMTS   4096
+#define REF_REGION_START(k) ((k) % (REF_TARGET_NELMTS - 8))
+#define REF_REGION_LEN(k)   (1 + (k) % 8)
+
+/* Check every REF_CHECK_STRIDE'th reference */
+#define REF_CHECK_STRIDE    97
+
+/* H5Rdereference2() appeared in v1.10.0 */
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 10
+#define HAVE_DEREFERENCE2
+#endif
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Record the rate of n operations in the given seconds */
+void
+report(const char *dname, const char *op, hsize_t n, double seconds)
+{
+    char metric[64];
+
+    sprintf(metric, "%s_%s", dname, op);
+    compat_timing("t_ref_scale", metric, seconds > 0.0 ? (double)n / seconds : 0.0, "refs/s");
+} /* report() */
+
+/* Check that object did is target k % REF_NTARGETS */
+int
+check_object(hid_t did, hsize_t k)
+{
+    int value = -1;
+
+    if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &value) < 0)
+        return -1;
+
+    return value == (int)(k % REF_NTARGETS) ? 0 : -1;
+} /* check_object() */
+
+/* Check that sid selects the region of reference k */
+int
+check_region(hid_t sid, hsize_t k)
+{
+    hsize_t blocks[2];
+
+    if(H5Sget_select_hyper_nblocks(sid) != 1
+            || H5Sget_select_hyper_blocklist(sid, (hsize_t)0, (hsize_t)1, blocks) < 0)
+        return -1;
+
+    return (blocks[0] == REF_REGION_START(k)
+            && blocks[1] == REF_REGION_START(k) + REF_REGION_LEN(k) - 1) ? 0 : -1;
+} /* check_region() */
+
+/* Open a reference dataset and read all of it with memory type tid,
+ * recording the rate as metric op */
+void *
+read_refs(hid_t fid, const char *dname, hid_t tid, size_t size, const char *op, hsize_t *n, FILE *fp)
+{
+    hid_t did, sid;
+    char name[64];
+    void *buf = NULL;
+    double t;
+
+    sprintf(name, "%s/%s", REF_GROUP, dname);
+    H5E_BEGIN_TRY {
+        did = H5Dopen(fid, name);
+    } H5E_END_TRY;
+    if(check(did < 0 ? -1 : 0, "references", name, "(open)", fp) < 0)
+        return NULL;
+
+    sid = H5Dget_space(did);
+    *n = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    H5Sclose(sid);
+
+    if((buf = malloc((size_t)*n * size + 1)) != NULL) {
+        t = compat_time_now();
+        if(H5Dread(did, tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0) {
+            free(buf);
+            buf = NULL;
+        }
+        else
+            report(dname, op, *n, compat_time_now() - t);
+    }
+    H5Dclose(did);
+
+    if(buf == NULL)
+        check(-1, "references", name, "(read)", fp);
+
+    return buf;
+} /* read_refs() */
+
+/* Follow old object references with H5Rdereference() */
+int
+old_object(hid_t fid, hobj_ref_t *refs, hsize_t n)
+{
+    hid_t did;
+    hsize_t k;
+    double t;
+    int bad = 0;
+
+    t = compat_time_now();
+    for(k = 0; k < n && !bad; k++) {
+        if((did = H5Rdereference(fid, H5R_OBJECT, &refs[k])) < 0)
+            bad = 1;
+        else
+            H5Dclose(did);
+    }
+    t = compat_time_now() - t;
+    if(!bad)
+        report("old_object", "dereference", n, t);
+
+#ifdef HAVE_DEREFERENCE2
+    t = compat_time_now();
+    for(k = 0; k < n && !bad; k++) {
+        if((did = H5Rdereference2(fid, H5P_DEFAULT, H5R_OBJECT, &refs[k])) < 0)
+            bad = 1;
+        else
+            H5Dclose(did);
+    }
+    t = compat_time_now() - t;
+    if(!bad)
+        report("old_object", "dereference2", n, t);
+#endif /* HAVE_DEREFERENCE2 */
+
+    for(k = 0; k < n && !bad; k += REF_CHECK_STRIDE) {
+        if((did = H5Rdereference(fid, H5R_OBJECT, &refs[k])) < 0)
+            return -1;
+        bad = check_object(did, k) < 0;
+        H5Dclose(did);
+    }
+
+    return bad ? -1 : 0;
+} /* old_object() */
+
+/* Follow old region references with H5Rdereference() and H5Rget_region() */
+int
+old_region(hid_t fid, hdset_reg_ref_t *refs, hsize_t n)
+{
+    hid_t did, sid;
+    hsize_t k;
+    double t;
+    int bad = 0;
+
+    t = compat_time_now();
+    for(k = 0; k < n && !bad; k++) {
+        if((did = H5Rdereference(fid, H5R_DATASET_REGION, &refs[k])) < 0)
+            bad = 1;
+        else
+            H5Dclose(did);
+    }
+    t = compat_time_now() - t;
+    if(!bad)
+        report("old_region", "dereference", n, t);
+
+#ifdef HAVE_DEREFERENCE2
+    t = compat_time_now();
+    for(k = 0; k < n && !bad; k++) {
+        if((did = H5Rdereference2(fid, H5P_DEFAULT, H5R_DATASET_REGION, &refs[k])) < 0)
+            bad = 1;
+        else
+            H5Dclose(did);
+    }
+    t = compat_time_now() - t;
+    if(!bad)
+        report("old_region", "dereference2", n, t);
+#endif /* HAVE_DEREFERENCE2 */
+
+    t = compat_time_now();
+    for(k = 0; k < n && !bad; k++) {
+        if((sid = H5Rget_region(fid, H5R_DATASET_REGION, &refs[k])) < 0)
+            bad = 1;
+        else
+            H5Sclose(sid);
+    }
+    t = compat_time_now() - t;
+    if(!bad)
+        report("old_region", "get_region", n, t);
+
+    for(k = 0; k < n && !bad; k += REF_CHECK_STRIDE) {
+        if((sid = H5Rget_region(fid, H5R_DATASET_REGION, &refs[k])) < 0)
+            return -1;
+        bad = check_region(sid, k) < 0;
+        H5Sclose(sid);
+    }
+
+    return bad ? -1 : 0;
+} /* old_region() */
+
+#if H5_VERS_MINOR >= 12
+/* Follow H5R_ref_t references with H5Ropen_object(), and for region
+ * references also H5Ropen_region(), then destroy them */
+int
+ref_t(const char *dname, H5R_ref_t *refs, hsize_t n, int region)
+{
+    hid_t did, sid;
+    hsize_t k;
+    double t;
+    int bad = 0;
+
+    t = compat_time_now();
+    for(k = 0; k < n && !bad; k++) {
+        if((did = H5Ropen_object(&refs[k], H5P_DEFAULT, H5P_DEFAULT)) < 0)
+            bad = 1;
+        else
+            H5Dclose(did);
+    }
+    t = compat_time_now() - t;
+    if(!bad)
+        report(dname, "open_object", n, t);
+
+    if(region) {
+        t = compat_time_now();
+        for(k = 0; k < n && !bad; k++) {
+            if((sid = H5Ropen_region(&refs[k], H5P_DEFAULT, H5P_DEFAULT)) < 0)
+                bad = 1;
+            else
+                H5Sclose(sid);
+        }
+        t = compat_time_now() - t;
+        if(!bad)
+            report(dname, "open_region", n, t);
+    }
+
+    for(k = 0; k < n && !bad; k += REF_CHECK_STRIDE) {
+        if(region) {
+            if((sid = H5Ropen_region(&refs[k], H5P_DEFAULT, H5P_DEFAULT)) < 0)
+                bad = 1;
+            else {
+                bad = check_region(sid, k) < 0;
+                H5Sclose(sid);
+            }
+        }
+        else {
+            if((did = H5Ropen_object(&refs[k], H5P_DEFAULT, H5P_DEFAULT)) < 0)
+                bad = 1;
+            else {
+                bad = check_object(did, k) < 0;
+                H5Dclose(did);
+            }
+        }
+    }
+
+    for(k = 0; k < n; k++)
+        H5Rdestroy(&refs[k]);
+
+    return bad ? -1 : 0;
+} /* ref_t() */
+#endif /* H5_VERS_MINOR >= 12 */
+
+int main(void)
+{
+    FILE *fp;
+
+    hid_t fid = -1;     /* File ID */
+    hobj_ref_t *obj_refs;
+    hdset_reg_ref_t *reg_refs;
+#if H5_VERS_MINOR >= 12
+    H5R_ref_t *refs;
+    const char *dnames[4] = {"old_object", "old_region", "revised_object", "revised_region"};
+#else
+    hid_t did;
+    const char *dnames[2] = {"revised_object", "revised_region"};
+#endif
+    char name[64];
+    int i;
+    hsize_t n;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    /* Open the test file */
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    /* The old reference types, as every release reads them */
+    if((obj_refs = (hobj_ref_t *)read_refs(fid, "old_object", H5T_STD_REF_OBJ, sizeof(hobj_ref_t), "read", &n, fp)) != NULL) {
+        check(old_object(fid, obj_refs, n), "references", REF_GROUP "/old_object", "(dereference)", fp);
+        free(obj_refs);
+    }
+    if((reg_refs = (hdset_reg_ref_t *)read_refs(fid, "old_region", H5T_STD_REF_DSETREG, sizeof(hdset_reg_ref_t), "read", &n, fp)) != NULL) {
+        check(old_region(fid, reg_refs, n), "references", REF_GROUP "/old_region", "(dereference)", fp);
+        free(reg_refs);
+    }
+
+#if H5_VERS_MINOR >= 12
+    /* The old and the revised datasets, all read as H5R_ref_t */
+    for(i = 0; i < 4; i++) {
+        if((refs = (H5R_ref_t *)read_refs(fid, dnames[i], H5T_STD_REF, sizeof(H5R_ref_t), "read_ref_t", &n, fp)) != NULL) {
+            sprintf(name, "%s/%s", REF_GROUP, dnames[i]);
+            check(ref_t(dnames[i], refs, n, i % 2), "references", name, "(H5R_ref_t)", fp);
+            free(refs);
+        }
+    }
+#else
+    /* The revised type is unknown to this release */
+    for(i = 0; i < 2; i++) {
+        sprintf(name, "%s/%s", REF_GROUP, dnames[i]);
+        H5E_BEGIN_TRY {
+            did = H5Dopen(fid, name);
+        } H5E_END_TRY;
+        if(check(did < 0 ? -1 : 0, "references", name, "(open)", fp) >= 0)
+            H5Dclose(did);
+    }
+#endif /* H5_VERS_MINOR >= 12 */
+
+    /* Close the file */
+    H5Fclose(fid);
+
+    /* Close the error log file */
+    fclose(fp);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,152 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_sohm_compat.c
+ *
+ *  Open each file tests/t_sohm.c creates, then open, read and check every
+ *  dataset in it.  The files with shared object header messages need the
+ *  v1.8 format, so v1.6 cannot open them.
+ *
+ *  For each file these go to TIMEPATH:
+ *
+ *      <file>_open_mean    mean H5Dopen() time, in us
+ *      <file>_open_p99     99th percentile of the H5Dopen() times, in us
+ *      <file>_metadata     file size less the raw data, in bytes
+ *      <file>_saved        metadata bytes saved against sohm_none.h5
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+
+/* The datasets, as in tests/t_sohm.c */
+#ifndef SOHM_NDSETS
+#define SOHM_NDSETS     20000
+#endif
+#define SOHM_NELMTS     8
+
+typedef struct {
+    int id;
+    double x;
+    double y;
+} sohm_t;
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Open file name, then open, read and check every dataset.  The bytes
+ * of metadata in the file are returned in *metadata. */
+int
+read_file(const char *name, double *metadata)
+{
+    hid_t fid, did, tid, dxpl;
+    sohm_t buf[SOHM_NELMTS];
+    char dname[32];
+    double *latency, raw = 0.0, total = 0.0, t;
+    struct stat sb;
+    int n, k, ret = 0;
+
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(name, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(fid < 0)
+        return -1;
+
+    /* Only the members to check; the others are left out of the read */
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(sohm_t));
+    H5Tinsert(tid, "id", HOFFSET(sohm_t, id), H5T_NATIVE_INT);
+    H5Tinsert(tid, "x", HOFFSET(sohm_t, x), H5T_NATIVE_DOUBLE);
+    H5Tinsert(tid, "y", HOFFSET(sohm_t, y), H5T_NATIVE_DOUBLE);
+    latency = (double *)malloc(sizeof(double) * SOHM_NDSETS);
+
+    /* The default 1 MB conversion buffer would be allocated and freed for
+     * every few hundred bytes read */
+    dxpl = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_buffer(dxpl, (size_t)4096, NULL, NULL);
+
+    for(n = 0; n < SOHM_NDSETS && ret == 0; n++) {
+        sprintf(dname, "/d%d", n);
+        t = compat_time_now();
+        did = H5Dopen(fid, dname);
+        latency[n] = compat_time_now() - t;
+        total += latency[n];
+        if(did < 0) {
+            ret = -1;
+            break;
+        }
+        raw += (double)H5Dget_storage_size(did);
+        if(H5Dread(did, tid, H5S_ALL, H5S_ALL, dxpl, buf) < 0)
+            ret = -1;
+        H5Dclose(did);
+        for(k = 0; k < SOHM_NELMTS && ret == 0; k++)
+            if(buf[k].id != n * SOHM_NELMTS + k || buf[k].x != buf[k].id / 2.0 || buf[k].y != -buf[k].x)
+                ret = -1;
+    }
+    H5Pclose(dxpl);
+    H5Tclose(tid);
+    H5Fclose(fid);
+
+    if(ret == 0) {
+        qsort(latency, (size_t)SOHM_NDSETS, sizeof(double), compat_cmp_double);
+        compat_timing_file("t_sohm", name, "open_mean", total / SOHM_NDSETS * 1000000.0, "us");
+        compat_timing_file("t_sohm", name, "open_p99", latency[SOHM_NDSETS * 99 / 100] * 1000000.0, "us");
+        if(stat(name, &sb) == 0) {
+            *metadata = (double)sb.st_size - raw;
+            compat_timing_file("t_sohm", name, "metadata", *metadata, "bytes");
+        }
+    }
+    free(latency);
+
+    return ret;
+} /* read_file() */
+
+int main(void)
+{
+    FILE *fp;
+    const char *names[3] = {"sohm_none.h5", "sohm_one.h5", "sohm_three.h5"};
+    double metadata, unshared = -1.0;
+    int f;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    for(f = 0; f < 3; f++) {
+        metadata = -1.0;
+        if(check(read_file(names[f], &metadata), "sohm", names[f], NULL, fp) < 0 || metadata < 0.0)
+            continue;
+        if(f == 0)
+            unshared = metadata;
+        else if(unshared >= 0.0)
+            compat_timing_file("t_sohm", names[f], "saved", unshared - metadata, "bytes");
+    }
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
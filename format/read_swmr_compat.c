@@ -0,0 +1,175 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_swmr_compat.c
+ *
+ *  Read swmr_compat.h5 while tests/t_swmr.c appends to it in SWMR mode.
+ *  From v1.10 on the file is opened with H5F_ACC_SWMR_READ, and the reader
+ *  polls SWMR_DSET with H5Drefresh() until it has seen all SWMR_NAPPENDS
+ *  records, in order, or SWMR_TIMEOUT expires.  Older libraries only try
+ *  to open the file, which is in the v1.10 format, and must fail.
+ *
+ *  Usage:  a.out <log file>
+ *      <log file>  receives the Passed/Error lines.  check_format.sh runs
+ *                  one of these programs per library release at the same
+ *                  time, so each needs its own log; they are collated into
+ *                  errors.log afterwards.
+ *
+ *  Percentiles of the time from writing a record to seeing it, and the
+ *  cost of H5Drefresh(), go to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "compat_timing.h"
+
+#define FILENAME "swmr_compat.h5"
+
+/* The dataset, as in tests/t_swmr.c */
+#define SWMR_DSET   "/append"
+#ifndef SWMR_NAPPENDS
+#define SWMR_NAPPENDS       2000
+#endif
+
+#define SWMR_TIMEOUT        60.0    /* Seconds to wait for all records */
+#define SWMR_POLL_USEC      200     /* Microseconds between polls */
+
+typedef struct {
+    long long seq;      /* Record number */
+    double stamp;       /* Wall clock time it was written */
+} swmr_record_t;
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 10
+/* Poll the dataset until every record has been seen; return -1 if one is
+ * missing or out of place */
+int
+poll_records(hid_t fid)
+{
+    hid_t did, tid, sid, mid;
+    hsize_t seen = 0, n, start, count;
+    swmr_record_t *buf;
+    double *latency;
+    double begin, t, now, refresh_time = 0.0;
+    long nrefresh = 0;
+    int bad = 0;
+
+    if((did = H5Dopen(fid, SWMR_DSET)) < 0)
+        return -1;
+
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(swmr_record_t));
+    H5Tinsert(tid, "seq", HOFFSET(swmr_record_t, seq), H5T_NATIVE_LLONG);
+    H5Tinsert(tid, "stamp", HOFFSET(swmr_record_t, stamp), H5T_NATIVE_DOUBLE);
+    buf = (swmr_record_t *)malloc(sizeof(swmr_record_t) * SWMR_NAPPENDS);
+    latency = (double *)malloc(sizeof(double) * SWMR_NAPPENDS);
+
+    begin = compat_time_now();
+    while(seen < SWMR_NAPPENDS && !bad && compat_time_now() - begin < SWMR_TIMEOUT) {
+        t = compat_time_now();
+        if(H5Drefresh(did) < 0)
+            bad = 1;
+        refresh_time += compat_time_now() - t;
+        nrefresh++;
+
+        sid = H5Dget_space(did);
+        n = (hsize_t)H5Sget_simple_extent_npoints(sid);
+        if(n > SWMR_NAPPENDS)
+            bad = 1;
+        else if(n > seen) {
+            start = seen;
+            count = n - seen;
+            mid = H5Screate_simple(1, &count, NULL);
+            H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, NULL, &count, NULL);
+            if(H5Dread(did, tid, mid, sid, H5P_DEFAULT, buf) < 0)
+                bad = 1;
+            now = compat_time_now();
+            H5Sclose(mid);
+            for(; seen < n && !bad; seen++) {
+                if(buf[seen - start].seq != (long long)seen)
+                    bad = 1;
+                latency[seen] = now - buf[seen - start].stamp;
+            }
+        }
+        else
+            usleep(SWMR_POLL_USEC);
+        H5Sclose(sid);
+    }
+
+    if(!bad && seen == SWMR_NAPPENDS) {
+        qsort(latency, (size_t)SWMR_NAPPENDS, sizeof(double), compat_cmp_double);
+        compat_timing("t_swmr", "visible_p50", latency[SWMR_NAPPENDS / 2] * 1000.0, "ms");
+        compat_timing("t_swmr", "visible_p90", latency[SWMR_NAPPENDS * 90 / 100] * 1000.0, "ms");
+        compat_timing("t_swmr", "visible_p99", latency[SWMR_NAPPENDS * 99 / 100] * 1000.0, "ms");
+        compat_timing("t_swmr", "visible_max", latency[SWMR_NAPPENDS - 1] * 1000.0, "ms");
+        compat_timing("t_swmr", "refresh_mean", refresh_time / nrefresh * 1000000.0, "us");
+        compat_timing("t_swmr", "refreshes", (double)nrefresh, "calls");
+    }
+
+    free(buf);
+    free(latency);
+    H5Tclose(tid);
+    H5Dclose(did);
+
+    return (bad || seen != SWMR_NAPPENDS) ? -1 : 0;
+} /* poll_records() */
+#endif /* H5_VERS_MINOR >= 10 */
+
+int main(int argc, char *argv[])
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s <log file>\n", argv[0]);
+        return 1;
+    }
+    if((fp = fopen(argv[1], "a")) == NULL)
+        return 1;
+
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 10
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(FILENAME, H5F_ACC_RDONLY | H5F_ACC_SWMR_READ, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, "(swmr read)", fp) >= 0) {
+        check(poll_records(fid), "swmr", SWMR_DSET, NULL, fp);
+        H5Fclose(fid);
+    }
+#else
+    /* Without SWMR, the file's format is too new for this library */
+    H5E_BEGIN_TRY {
+        fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) >= 0)
+        H5Fclose(fid);
+#endif
+
+    fclose(fp);
+
+    return 0;
+} /* main() */
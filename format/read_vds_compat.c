@@ -0,0 +1,187 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_vds_compat.c
+ *
+ *  Open the virtual datasets tests/t_vds.c adds to vds_compat.h5 and, if
+ *  this library can, read each of them whole and VDS_NPARTIAL times in
+ *  parts that span three source files, checking every value.  Libraries
+ *  before v1.10 cannot open a virtual dataset, so they log an error for
+ *  the open only.
+ *
+ *  For each dataset these go to TIMEPATH:
+ *
+ *      <dset>_open         H5Dopen() and H5Dget_space(), in ms; the extent
+ *                          of vds_printf is resolved from the source
+ *                          files found
+ *      <dset>_full_read    MB/s
+ *      <dset>_partial_read reads per second
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "compat_timing.h"
+
+#define FILEPATH "./errors.log"
+#define FILENAME "vds_compat.h5"
+
+/* Elements of each source file, as in gen_vds_compat.c */
+#define VDS_SRC_NELMTS  16384
+
+/* Partial reads per dataset */
+#define VDS_NPARTIAL    16
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Record one metric of dataset dname */
+static void
+report(const char *dname, const char *what, double value, const char *unit)
+{
+    char metric[64];
+
+    sprintf(metric, "%s_%s", dname + 1, what);
+    compat_timing("t_vds", metric, value, unit);
+} /* report() */
+
+/* Read all of did and check that element k holds k */
+int
+full_read(hid_t did, const char *dname, hsize_t nelmts)
+{
+    int *buf;
+    hsize_t k;
+    double t;
+    int ret = 0;
+
+    if((buf = (int *)malloc((size_t)nelmts * sizeof(int) + 1)) == NULL)
+        return -1;
+
+    t = compat_time_now();
+    if(H5Dread(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf) < 0)
+        ret = -1;
+    t = compat_time_now() - t;
+
+    for(k = 0; k < nelmts && ret == 0; k++)
+        if(buf[k] != (int)k)
+            ret = -1;
+    free(buf);
+
+    if(ret == 0)
+        report(dname, "full_read", compat_mbps((double)nelmts * sizeof(int), t), "MB/s");
+
+    return ret;
+} /* full_read() */
+
+/* Read VDS_NPARTIAL parts of did spread over the dataset, each spanning
+ * three source files, and check them */
+int
+partial_read(hid_t did, hid_t sid, const char *dname, hsize_t nelmts)
+{
+    hid_t mid;
+    hsize_t start, count, k;
+    int *buf;
+    double t, elapsed = 0.0;
+    int j, ret = 0;
+
+    count = 2 * VDS_SRC_NELMTS;
+    if(nelmts < count + VDS_SRC_NELMTS)
+        return -1;
+    if((buf = (int *)malloc((size_t)count * sizeof(int))) == NULL)
+        return -1;
+    mid = H5Screate_simple(1, &count, NULL);
+
+    for(j = 0; j < VDS_NPARTIAL && ret == 0; j++) {
+        start = VDS_SRC_NELMTS / 2
+                + (nelmts - count - VDS_SRC_NELMTS) / VDS_SRC_NELMTS * j / (VDS_NPARTIAL - 1) * VDS_SRC_NELMTS;
+        H5Sselect_hyperslab(sid, H5S_SELECT_SET, &start, NULL, &count, NULL);
+        t = compat_time_now();
+        if(H5Dread(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, buf) < 0)
+            ret = -1;
+        elapsed += compat_time_now() - t;
+        for(k = 0; k < count && ret == 0; k++)
+            if(buf[k] != (int)(start + k))
+                ret = -1;
+    }
+    H5Sclose(mid);
+    free(buf);
+
+    if(ret == 0)
+        report(dname, "partial_read", elapsed > 0.0 ? VDS_NPARTIAL / elapsed : 0.0, "reads/s");
+
+    return ret;
+} /* partial_read() */
+
+/* Open virtual dataset dname, then read it if it opened */
+void
+read_vds(hid_t fid, const char *dname, FILE *fp)
+{
+    hid_t did, sid = -1;
+    hsize_t nelmts = 0;
+    double t;
+
+    t = compat_time_now();
+    H5E_BEGIN_TRY {
+        if((did = H5Dopen(fid, dname)) >= 0)
+            sid = H5Dget_space(did);
+    } H5E_END_TRY;
+    t = compat_time_now() - t;
+    if(check(sid < 0 ? -1 : 0, "vds", dname, "(open)", fp) < 0) {
+        if(did >= 0)
+            H5Dclose(did);
+        return;
+    }
+    report(dname, "open", t * 1000.0, "ms");
+    nelmts = (hsize_t)H5Sget_simple_extent_npoints(sid);
+
+    check(full_read(did, dname, nelmts), "vds", dname, "(full read)", fp);
+    check(partial_read(did, sid, dname, nelmts), "vds", dname, "(partial read)", fp);
+
+    H5Sclose(sid);
+    H5Dclose(did);
+} /* read_vds() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    read_vds(fid, "/vds_explicit", fp);
+    read_vds(fid, "/vds_printf", fp);
+
+    H5Fclose(fid);
+    fclose(fp);
+
+    return 0;
+} /* main() */
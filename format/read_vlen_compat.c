@@ -0,0 +1,266 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions with:
+ *      h5cc -DH5_USE_16_API read_vlen_compat.c
+ *
+ *  Read the variable-length fixture of compat_vlen.h from both groups of
+ *  vlen_compat.h5: /gen, written by gen_vlen_compat.c with v1.6, and /mod,
+ *  written by tests/t_vlen.c.  Every value is checked, and a dataset only
+ *  passes if reclaiming it frees all the memory the read allocated.
+ *
+ *  The datasets are read through a counting memory manager
+ *  (H5Pset_vlen_mem_manager) so that the heap memory each read needs is
+ *  known.  For each dataset these go to TIMEPATH:
+ *
+ *      <group>_<dset>_read       elements read per second
+ *      <group>_<dset>_reclaim    elements reclaimed per second, with
+ *                                H5Dvlen_reclaim() or, from v1.12 on,
+ *                                H5Treclaim()
+ *      <group>_<dset>_heap       bytes allocated by the read
+ *      <group>_<dset>_allocs     allocations made by the read
+ *      <group>_<dset>_bufsize    H5Dvlen_get_buf_size()
+ *
+ *  and the read rate of each attribute as <group>_attr_read.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "compat_timing.h"
+#include "compat_vlen.h"
+
+#define FILEPATH "./errors.log"
+#define FILENAME "vlen_compat.h5"
+
+/* What the counting memory manager has handed out */
+static double vl_bytes;         /* Bytes allocated */
+static double vl_allocs;        /* Allocations */
+static double vl_live;          /* Bytes not freed yet */
+
+/* Each block starts with its size, padded to keep the data aligned */
+typedef union {
+    size_t size;
+    double align;
+} vl_header_t;
+
+static void *
+vl_malloc(size_t size, void *info)
+{
+    vl_header_t *h;
+
+    if((h = (vl_header_t *)malloc(sizeof(vl_header_t) + size)) == NULL)
+        return NULL;
+    h->size = size;
+    vl_bytes += (double)size;
+    vl_allocs += 1.0;
+    vl_live += (double)size;
+
+    return h + 1;
+} /* vl_malloc() */
+
+static void
+vl_free(void *mem, void *info)
+{
+    vl_header_t *h;
+
+    if(mem != NULL) {
+        h = (vl_header_t *)mem - 1;
+        vl_live -= (double)h->size;
+        free(h);
+    }
+} /* vl_free() */
+
+/* Verify the returned value and print the given message */
+int
+check(int ret, const char *type, const char *name, const char *message, FILE *fp)
+{
+    if(ret < 0)
+        fprintf(fp, "Error: %s %s %s\n", type, name, message ? message : "(null)");
+    else
+        fprintf(fp, "Passed: %s %s %s\n", type, name, message ? message : "(null)");
+
+    return ret;
+} /* check() */
+
+/* Free what a read of a variable-length type allocated */
+static herr_t
+reclaim(hid_t tid, hid_t sid, hid_t dxpl, void *buf)
+{
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 12
+    return H5Treclaim(tid, sid, dxpl, buf);
+#else
+    return H5Dvlen_reclaim(tid, sid, dxpl, buf);
+#endif
+} /* reclaim() */
+
+/* Record one metric of group gname's object oname */
+static void
+report(const char *gname, const char *oname, const char *what, double value, const char *unit)
+{
+    char metric[64];
+
+    sprintf(metric, "%s_%s_%s", gname, oname, what);
+    compat_timing("t_vlen", metric, value, unit);
+} /* report() */
+
+/* Read dataset dname ("strings" or "sequences") of group gid, check it,
+ * reclaim it and record the costs */
+int
+read_dset(hid_t gid, const char *gname, const char *dname)
+{
+    hid_t did, sid, tid, dxpl;
+    hsize_t nelmts, bufsize = 0;
+    void *buf;
+    double t;
+    int is_str, ret = 0;
+
+    H5E_BEGIN_TRY {
+        did = H5Dopen(gid, dname);
+    } H5E_END_TRY;
+    if(did < 0)
+        return -1;
+
+    is_str = dname[0] == 's' && dname[1] == 't';
+    tid = is_str ? vlen_str_type() : H5Tvlen_create(H5T_NATIVE_INT);
+    sid = H5Dget_space(did);
+    nelmts = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    if((buf = malloc((size_t)nelmts * (is_str ? sizeof(char *) : sizeof(hvl_t)) + 1)) == NULL) {
+        H5Sclose(sid);
+        H5Tclose(tid);
+        H5Dclose(did);
+        return -1;
+    }
+
+    dxpl = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_vlen_mem_manager(dxpl, vl_malloc, NULL, vl_free, NULL);
+    vl_bytes = vl_allocs = vl_live = 0.0;
+
+    t = compat_time_now();
+    if(H5Dread(did, tid, H5S_ALL, H5S_ALL, dxpl, buf) < 0)
+        ret = -1;
+    t = compat_time_now() - t;
+
+    if(ret == 0) {
+        report(gname, dname, "read", t > 0.0 ? (double)nelmts / t : 0.0, "elmts/s");
+        report(gname, dname, "heap", vl_bytes, "bytes");
+        report(gname, dname, "allocs", vl_allocs, "count");
+        if(H5Dvlen_get_buf_size(did, tid, sid, &bufsize) >= 0)
+            report(gname, dname, "bufsize", (double)bufsize, "bytes");
+
+        if(is_str)
+            ret = vlen_str_verify((char * const *)buf, (size_t)nelmts);
+        else
+            ret = vlen_seq_verify((const hvl_t *)buf, (size_t)nelmts);
+
+        t = compat_time_now();
+        if(reclaim(tid, sid, dxpl, buf) < 0 || vl_live != 0.0)
+            ret = -1;
+        t = compat_time_now() - t;
+        report(gname, dname, "reclaim", t > 0.0 ? (double)nelmts / t : 0.0, "elmts/s");
+    }
+
+    free(buf);
+    H5Pclose(dxpl);
+    H5Sclose(sid);
+    H5Tclose(tid);
+    H5Dclose(did);
+
+    return ret;
+} /* read_dset() */
+
+/* Read the strings attribute of group gid and check it */
+int
+read_attr(hid_t gid, const char *gname)
+{
+    hid_t aid, sid, tid;
+    hsize_t nelmts;
+    char **buf;
+    double t;
+    int ret = 0;
+
+    H5E_BEGIN_TRY {
+        aid = H5Aopen_name(gid, "strings");
+    } H5E_END_TRY;
+    if(aid < 0)
+        return -1;
+
+    tid = vlen_str_type();
+    sid = H5Aget_space(aid);
+    nelmts = (hsize_t)H5Sget_simple_extent_npoints(sid);
+    if((buf = (char **)malloc((size_t)nelmts * sizeof(char *) + 1)) == NULL)
+        ret = -1;
+
+    if(ret == 0) {
+        t = compat_time_now();
+        if(H5Aread(aid, tid, buf) < 0)
+            ret = -1;
+        t = compat_time_now() - t;
+        if(ret == 0) {
+            report(gname, "attr", "read", t > 0.0 ? (double)nelmts / t : 0.0, "elmts/s");
+            ret = vlen_str_verify(buf, (size_t)nelmts);
+            reclaim(tid, sid, H5P_DEFAULT, buf);
+        }
+        free(buf);
+    }
+
+    H5Sclose(sid);
+    H5Tclose(tid);
+    H5Aclose(aid);
+
+    return ret;
+} /* read_attr() */
+
+int main(void)
+{
+    FILE *fp;
+    hid_t fid;          /* File ID */
+    hid_t gid;          /* Group ID */
+    const char *gnames[2] = {"gen", "mod"};
+    char name[64];
+    int i;
+
+    /* Open the error log file */
+    fp = fopen(FILEPATH, "a");
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(check(fid < 0 ? -1 : 0, "file", FILENAME, NULL, fp) < 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    for(i = 0; i < 2; i++) {
+        sprintf(name, "/%s", gnames[i]);
+        H5E_BEGIN_TRY {
+            gid = H5Gopen(fid, name);
+        } H5E_END_TRY;
+        if(check(gid < 0 ? -1 : 0, "group", name, NULL, fp) < 0)
+            continue;
+
+        sprintf(name, "/%s/strings", gnames[i]);
+        check(read_dset(gid, gnames[i], "strings"), "vlen", name, NULL, fp);
+        sprintf(name, "/%s/sequences", gnames[i]);
+        check(read_dset(gid, gnames[i], "sequences"), "vlen", name, NULL, fp);
+        sprintf(name, "/%s/strings", gnames[i]);
+        check(read_attr(gid, gnames[i]), "vlen", name, "(attribute)", fp);
+
+        H5Gclose(gid);
+    }
+
+    H5Fclose(fid);
+    fclose(fp);
+
+    return 0;
+} /* main() */
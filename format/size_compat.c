@@ -0,0 +1,194 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled with v1.8 and later library releases with:
+ *      h5cc size_compat.c
+ *
+ *  Report where the bytes of a test file go: the file size, the free space
+ *  the library knows about, superblock and shared message bytes from
+ *  H5Fget_info(), object header and index/heap bytes summed over every
+ *  object, and the raw data storage of the datasets.  What is left over
+ *  ("unaccounted") is mostly space a modification left behind.
+ *
+ *  Usage:  a.out <file> <test> before|after [<label>]
+ *      before  is run on the file before the test modifies it, and records
+ *              the file size in SIZE_BASELINE.
+ *      after   is run once the test has modified the file, and also
+ *              reports how much the file grew since before, if it ran.
+ *      label   tells apart the files of a test that has several; it goes
+ *              in front of the metric names and the baseline file name.
+ *
+ *  The sizes depend on the writing library, so they go to TIMEPATH with
+ *  the stage in the metric name, never to errors.log.  check_format.sh
+ *  runs this through SizeReport().
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <string.h>
+#include "compat_timing.h"
+
+#define SIZE_BASELINE "./size_baseline%s%.31s.txt"  /* Sizes before modification */
+
+/* Bytes found while visiting the objects */
+typedef struct {
+    hsize_t nobjs;          /* Objects visited */
+    hsize_t hdr;            /* Object header bytes */
+    hsize_t hdr_free;       /* Free bytes inside object headers */
+    hsize_t index;          /* B-tree/index and heap bytes of groups, chunks */
+    hsize_t attr;           /* Dense attribute index and heap bytes */
+    hsize_t raw;            /* Dataset raw data storage */
+} size_info_t;
+
+/* Add one dataset's raw data storage */
+static void
+add_raw(hid_t loc, const char *name, size_info_t *sz)
+{
+    hid_t did;
+
+    if((did = H5Dopen2(loc, name, H5P_DEFAULT)) >= 0) {
+        sz->raw += H5Dget_storage_size(did);
+        H5Dclose(did);
+    }
+} /* add_raw() */
+
+/* H5Ovisit() callback: add up the bytes of one object */
+#if H5_VERS_MINOR >= 12
+static herr_t
+visit_cb(hid_t loc, const char *name, const H5O_info2_t *info, void *udata)
+{
+    size_info_t *sz = (size_info_t *)udata;
+    H5O_native_info_t ninfo;
+
+    if(H5Oget_native_info_by_name(loc, name, &ninfo,
+                H5O_NATIVE_INFO_HDR | H5O_NATIVE_INFO_META_SIZE, H5P_DEFAULT) < 0)
+        return -1;
+    sz->nobjs++;
+    sz->hdr += ninfo.hdr.space.total;
+    sz->hdr_free += ninfo.hdr.space.free;
+    sz->index += ninfo.meta_size.obj.index_size + ninfo.meta_size.obj.heap_size;
+    sz->attr += ninfo.meta_size.attr.index_size + ninfo.meta_size.attr.heap_size;
+#else
+static herr_t
+visit_cb(hid_t loc, const char *name, const H5O_info_t *info, void *udata)
+{
+    size_info_t *sz = (size_info_t *)udata;
+
+    sz->nobjs++;
+    sz->hdr += info->hdr.space.total;
+    sz->hdr_free += info->hdr.space.free;
+    sz->index += info->meta_size.obj.index_size + info->meta_size.obj.heap_size;
+    sz->attr += info->meta_size.attr.index_size + info->meta_size.attr.heap_size;
+#endif
+    if(info->type == H5O_TYPE_DATASET)
+        add_raw(loc, name, sz);
+
+    return 0;
+} /* visit_cb() */
+
+int main(int argc, char *argv[])
+{
+    hid_t fid;              /* File ID */
+    hsize_t file_size;
+    hssize_t freespace;
+    hsize_t super = 0, sohm = 0, accounted, unaccounted;
+    size_info_t sz;
+    const char *test, *stage, *label;
+    char prefix[64], metric[96], baseline[96];
+    FILE *bp;
+    int after;
+#if H5_VERS_MINOR >= 10
+    H5F_info2_t finfo;
+#else
+    H5F_info_t finfo;
+#endif
+
+    if(argc < 4) {
+        fprintf(stderr, "usage: %s <file> <test> before|after [<label>]\n", argv[0]);
+        return 1;
+    }
+    test = argv[2];
+    stage = argv[3];
+    label = argc > 4 ? argv[4] : "";
+    after = !strcmp(stage, "after");
+    sprintf(prefix, "%.31s%s%s", label, *label ? "_" : "", stage);
+    sprintf(baseline, SIZE_BASELINE, *label ? "_" : "", label);
+
+    if((fid = H5Fopen(argv[1], H5F_ACC_RDONLY, H5P_DEFAULT)) < 0)
+        return 1;
+
+    H5Fget_filesize(fid, &file_size);
+    freespace = H5Fget_freespace(fid);
+
+    /* Superblock and shared object header message table */
+    memset(&finfo, 0, sizeof(finfo));
+#if H5_VERS_MINOR >= 10
+    H5Fget_info2(fid, &finfo);
+    super = finfo.super.super_size + finfo.super.super_ext_size;
+#else
+    H5Fget_info(fid, &finfo);
+    super = finfo.super_ext_size;
+#endif
+    sohm = finfo.sohm.hdr_size + finfo.sohm.msgs_info.index_size + finfo.sohm.msgs_info.heap_size;
+
+    /* Every object once, however many links point to it */
+    memset(&sz, 0, sizeof(sz));
+#if H5_VERS_MINOR >= 12
+    H5Ovisit3(fid, H5_INDEX_NAME, H5_ITER_NATIVE, visit_cb, &sz, H5O_INFO_BASIC);
+#else
+    H5Ovisit(fid, H5_INDEX_NAME, H5_ITER_NATIVE, visit_cb, &sz);
+#endif
+
+    accounted = super + sohm + sz.hdr + sz.index + sz.attr + sz.raw;
+    unaccounted = file_size > accounted ? file_size - accounted : 0;
+
+#define SIZE_METRIC(what, value, unit) \
+    (sprintf(metric, "%s_%s", prefix, what), compat_timing(test, metric, (double)(value), unit))
+
+    SIZE_METRIC("file_size", file_size, "bytes");
+    SIZE_METRIC("freespace", freespace < 0 ? 0 : freespace, "bytes");
+#if H5_VERS_MINOR >= 10
+    SIZE_METRIC("free_sections", H5Fget_free_sections(fid, H5FD_MEM_DEFAULT, 0, NULL), "sections");
+#endif
+    SIZE_METRIC("objects", sz.nobjs, "objects");
+    SIZE_METRIC("superblock", super, "bytes");
+    SIZE_METRIC("sohm", sohm, "bytes");
+    SIZE_METRIC("ohdr", sz.hdr, "bytes");
+    SIZE_METRIC("ohdr_free", sz.hdr_free, "bytes");
+    SIZE_METRIC("index_heap", sz.index + sz.attr, "bytes");
+    SIZE_METRIC("metadata", super + sohm + sz.hdr + sz.index + sz.attr, "bytes");
+    SIZE_METRIC("raw", sz.raw, "bytes");
+    SIZE_METRIC("unaccounted", unaccounted, "bytes");
+
+    /* How much the test added, against the file before modification */
+    if(!after) {
+        if((bp = fopen(baseline, "w")) != NULL) {
+            fprintf(bp, "%llu %llu\n", (unsigned long long)file_size, (unsigned long long)unaccounted);
+            fclose(bp);
+        }
+    } else if((bp = fopen(baseline, "r")) != NULL) {
+        unsigned long long base_size, base_unaccounted;
+
+        if(fscanf(bp, "%llu %llu", &base_size, &base_unaccounted) == 2) {
+            SIZE_METRIC("growth", (double)file_size - (double)base_size, "bytes");
+            SIZE_METRIC("unaccounted_growth", (double)unaccounted - (double)base_unaccounted, "bytes");
+        }
+        fclose(bp);
+    }
+
+    H5Fclose(fid);
+
+    return 0;
+} /* main() */
@@ -0,0 +1,147 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_attrs.c
+ *
+ *  Create datasets carrying many attributes:
+ *
+ *      attr_v16.h5:/compact_<n>    n = 1000 and 10000, in the default
+ *                                  format, which keeps every attribute in
+ *                                  the object header, as v1.6 does
+ *      attr_v16.h5:/ph<c>_<n>      n = 1000 and 10000, with
+ *                                  H5Pset_attr_phase_change() max_compact
+ *                                  c of 0 (always dense), 8 (the default)
+ *                                  and 1000, and attribute creation order
+ *                                  tracked (H5Pset_attr_creation_order)
+ *      attr_v18.h5:/ph<c>_<n>      n = 1000 up to ATTR_MAX, in the v1.8
+ *                                  format, with the same max_compact and
+ *                                  without creation order
+ *
+ *  Tracking creation order gives a dataset a v1.8 object header, and so
+ *  dense attribute storage, even in a file in the default format, so v1.6
+ *  readers meet the /ph<c>_<n> datasets of attr_v16.h5 next to the ones
+ *  they can read.
+ *
+ *  A v1.6-format object header counts its messages in 16 bits, and adding
+ *  to it gets slower with every attribute, while the creation order index
+ *  of an object is 16 bits too, so attr_v16.h5 stops at 10000.
+ *  Each dataset holds one integer; attribute attr<i>, i written with six
+ *  digits, holds i.
+ *
+ *  The time to attach the attributes of each dataset goes to TIMEPATH as
+ *  <file>_<dset>_create.
+ */
+
+#include <stdio.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* HDF5 v1.8 defined H5F_LIBVER_18, but doesn't have H5F_LIBVER_V18.
+ * See tests/t_newdata.c.
+ */
+#if defined(H5F_LIBVER_18)
+#define H5F_LIBVER_V18 H5F_LIBVER_18
+#endif
+
+/* The datasets, as in read_attrs_compat.c */
+#ifndef ATTR_MAX
+#define ATTR_MAX        100000
+#endif
+#define ATTR_V16_MAX    10000
+
+/* Create dataset name of file fname with creation property list dcpl and
+ * n attributes */
+static void
+create_dset(hid_t fid, const char *fname, const char *name, hid_t dcpl, long n)
+{
+    hid_t sid;          /* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hid_t aid;          /* attribute ID */
+    char aname[32], metric[64];
+    double t;
+    int value = 0;
+    long i;
+
+    sid = H5Screate(H5S_SCALAR);
+    did = H5Dcreate(fid, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &value);
+
+    t = compat_time_now();
+    for(i = 0; i < n; i++) {
+        sprintf(aname, "attr%06ld", i);
+        value = (int)i;
+        aid = H5Acreate(did, aname, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT);
+        H5Awrite(aid, H5T_NATIVE_INT, &value);
+        H5Aclose(aid);
+    }
+    H5Dclose(did);
+    H5Sclose(sid);
+
+    sprintf(metric, "%s_create", name + 1);
+    compat_timing_file("t_attrs", fname, metric, (compat_time_now() - t) * 1000.0, "ms");
+}
+
+int main(int argc, char *argv[])
+{
+    hid_t fid;		/* file ID */
+    hid_t fapl;		/* file access property list */
+    hid_t dcpl;		/* dataset creation property list */
+    unsigned max_compact[3] = {0, 8, 1000};
+    char name[32];
+    long n;
+    int p;
+
+    fid = H5Fcreate("attr_v16.h5", H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    for(n = 1000; n <= ATTR_V16_MAX; n *= 10) {
+        sprintf(name, "/compact_%ld", n);
+        create_dset(fid, "attr_v16.h5", name, H5P_DEFAULT, n);
+    }
+
+    /* Creation order needs the v1.8 object header in any format */
+    for(p = 0; p < 3; p++) {
+        dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_attr_phase_change(dcpl, max_compact[p], max_compact[p] * 4 / 5);
+        H5Pset_attr_creation_order(dcpl, H5P_CRT_ORDER_TRACKED);
+        for(n = 1000; n <= ATTR_V16_MAX; n *= 10) {
+            sprintf(name, "/ph%u_%ld", max_compact[p], n);
+            create_dset(fid, "attr_v16.h5", name, dcpl, n);
+        }
+        H5Pclose(dcpl);
+    }
+    H5Fclose(fid);
+
+   /* Dense attribute storage needs the v1.8 object header */
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if(H5F_LIBVER_LATEST > 1)
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+    else
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    fid = H5Fcreate("attr_v18.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    H5Pclose(fapl);
+
+    for(p = 0; p < 3; p++) {
+        dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_attr_phase_change(dcpl, max_compact[p], max_compact[p] * 4 / 5);
+        for(n = 1000; n <= ATTR_MAX; n *= 10) {
+            sprintf(name, "/ph%u_%ld", max_compact[p], n);
+            create_dset(fid, "attr_v18.h5", name, dcpl, n);
+        }
+        H5Pclose(dcpl);
+    }
+    H5Fclose(fid);
+
+    return 0;
+}
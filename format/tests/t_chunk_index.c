@@ -0,0 +1,147 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  Add one chunked dataset per chunk index type to compat.h5, in the group
+ *  CHUNK_GROUP.  Each is CHUNK_N x CHUNK_N integers in CHUNK_DIM x CHUNK_DIM
+ *  chunks (4096 chunks by default), and element (i, j) holds i * CHUNK_N + j.
+ *
+ *  "btree1" is created with the v1.8 format, which always uses a version 1
+ *  B-tree.  With v1.10 and later the file is then reopened with the latest
+ *  format, under which the library picks the index from the dataset:
+ *
+ *      single      one chunk covering fixed dimensions
+ *      implicit    fixed dimensions, space allocated early, no filters
+ *      farray      fixed dimensions (fixed array)
+ *      earray      one unlimited dimension (extensible array)
+ *      btree2      two unlimited dimensions (version 2 B-tree)
+ *
+ *  v1.8 writes the same datasets, all with a version 1 B-tree.
+ */
+
+#include "hdf5.h"
+#include <stdlib.h>
+#include "../compat_timing.h"
+
+#define FILENAME "compat.h5"
+
+/* HDF5 v1.8 defined H5F_LIBVER_18, but doesn't have H5F_LIBVER_V18.  These
+ * tests originally set libver_bounds to H5F_LIBVER_LATEST, H5F_LIBVER_LATEST,
+ * which is appropriate for v1.8, but for v1.10 and later, we need to set
+ * them to H5F_LIBVER_V18, H5F_LIBVER_LATEST.  In order to allow compiling
+ * the part of the if(H5F_LIBVER_LATEST > 1) for the later versions with v1.8
+ * this define is added.
+ */
+#if defined(H5F_LIBVER_18)
+#define H5F_LIBVER_V18 H5F_LIBVER_18
+#endif
+
+#define CHUNK_GROUP "/chunk_index"
+
+#ifndef CHUNK_N
+#define CHUNK_N     1024
+#endif
+#ifndef CHUNK_DIM
+#define CHUNK_DIM   16
+#endif
+
+/* Create and write one dataset, and time the write */
+static void
+write_dset(hid_t gid, const char *name, int nunlimited, int single, int early, const int *buf)
+{
+    hid_t sid;		/* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hid_t dcpl;		/* dataset creation property list */
+    hsize_t dims[2], maxdims[2], chunk[2];
+    char metric[64];
+    double t;
+
+    dims[0] = dims[1] = CHUNK_N;
+    maxdims[0] = nunlimited > 0 ? H5S_UNLIMITED : CHUNK_N;
+    maxdims[1] = nunlimited > 1 ? H5S_UNLIMITED : CHUNK_N;
+    chunk[0] = chunk[1] = single ? CHUNK_N : CHUNK_DIM;
+
+    sid = H5Screate_simple(2, dims, maxdims);
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, 2, chunk);
+    if(early)
+        H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY);
+
+    t = compat_time_now();
+    did = H5Dcreate(gid, name, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+    H5Dclose(did);
+    t = compat_time_now() - t;
+
+    sprintf(metric, "%s_write", name);
+    compat_timing("t_chunk_index", metric, compat_mbps((double)CHUNK_N * CHUNK_N * sizeof(int), t), "MB/s");
+
+    H5Pclose(dcpl);
+    H5Sclose(sid);
+}
+
+int main(int argc, char *argv[])
+{
+/* =====  Variables  ===== */
+
+    hid_t fid;		/* file ID */
+    hid_t gid;          /* group ID */
+
+    hid_t fapl;		/* file access property list */
+
+    int *buf;
+    int i, j;
+
+/* =====  Main processing  ===== */
+
+    buf = (int *)malloc(sizeof(int) * CHUNK_N * CHUNK_N);
+    for (i = 0; i < CHUNK_N; i++)
+        for (j = 0; j < CHUNK_N; j++)
+            buf[i * CHUNK_N + j] = i * CHUNK_N + j;
+
+   /* Open File */
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if(H5F_LIBVER_LATEST > 1)
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+    else
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, fapl);
+
+   /* Create Group and the v1.8 format dataset */
+    gid = H5Gcreate(fid, CHUNK_GROUP, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    write_dset(gid, "btree1", 0, 0, 0, buf);
+
+   /* The other index types need the latest format */
+#if H5_VERS_MINOR >= 10
+    H5Gclose(gid);
+    H5Fclose(fid);
+    H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, fapl);
+    gid = H5Gopen(fid, CHUNK_GROUP, H5P_DEFAULT);
+#endif
+    write_dset(gid, "single", 0, 1, 0, buf);
+    write_dset(gid, "implicit", 0, 0, 1, buf);
+    write_dset(gid, "farray", 0, 0, 0, buf);
+    write_dset(gid, "earray", 1, 0, 0, buf);
+    write_dset(gid, "btree2", 2, 0, 0, buf);
+
+   /* Close */
+    H5Gclose(gid);
+    H5Pclose(fapl);
+    H5Fclose(fid);
+
+    free(buf);
+
+    return 0;
+}
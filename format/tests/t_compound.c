@@ -0,0 +1,73 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  Add COMPOUND_DSET to compat.h5: COMPOUND_NELMTS elements of the dset1
+ *  compound type, contiguous, holding the values of compat_dset1.h.  The
+ *  file is opened with the default (earliest) format so that v1.6 can read
+ *  the dataset, and read_compound_compat.c reads it into several memory
+ *  types to time the compound conversions of each library release.
+ *
+ *  The write rate goes to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include "../compat_timing.h"
+#include "../compat_dset1.h"
+
+#define FILENAME "compat.h5"
+
+#define COMPOUND_GROUP "/compound"
+#define COMPOUND_DSET  COMPOUND_GROUP "/dset1"
+
+/* Elements in COMPOUND_DSET, 40 MB of dset1_t */
+#ifndef COMPOUND_NELMTS
+#define COMPOUND_NELMTS 131072
+#endif
+
+int main(int argc, char *argv[])
+{
+    hid_t fid;		/* file ID */
+    hid_t gid;          /* group ID */
+    hid_t sid;		/* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hid_t tid;          /* datatype ID */
+    hsize_t dims[1];
+    double t;
+
+   /* Open File, keeping the format v1.6 can read */
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, H5P_DEFAULT);
+    gid = H5Gcreate(fid, COMPOUND_GROUP, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    tid = dset1_create_type();
+    dims[0] = COMPOUND_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+
+   /* Create and write the dataset */
+    t = compat_time_now();
+    did = H5Dcreate(fid, COMPOUND_DSET, tid, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    dset1_write(did, tid, (hsize_t)COMPOUND_NELMTS);
+    H5Dclose(did);
+    t = compat_time_now() - t;
+    compat_timing("t_compound", "native_write",
+            compat_mbps((double)COMPOUND_NELMTS * sizeof(dset1_t), t), "MB/s");
+
+   /* Close */
+    H5Sclose(sid);
+    H5Tclose(tid);
+    H5Gclose(gid);
+    H5Fclose(fid);
+
+    return 0;
+}
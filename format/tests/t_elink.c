@@ -0,0 +1,106 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_elink.c
+ *
+ *  Create ELINK_NFILES sibling files elink_<i>.h5, each with
+ *  ELINK_PER_FILE datasets /d<j> of ELINK_NELMTS integers, element k
+ *  holding i * 1000 + j * 10 + k, and add group g6 to compat.h5 with an
+ *  external link e<i>_<j> to each of them:
+ *
+ *      /
+ *      |
+ *      g6 --> elink_0.h5:/d0, elink_1.h5:/d0, ... elink_0.h5:/d1, ...
+ *
+ *  g6 tracks creation order, so it holds link messages even in the v1.6
+ *  format of compat.h5, and the links are created file by file for each
+ *  j, so that visiting them in creation order moves to another file at
+ *  every link.
+ */
+
+#include <stdio.h>
+#include "hdf5.h"
+
+#define FILENAME "compat.h5"
+
+/* The files and links, as in read_elink_compat.c */
+#ifndef ELINK_NFILES
+#define ELINK_NFILES    64
+#endif
+#define ELINK_PER_FILE  16
+#define ELINK_NELMTS    16
+
+int main(int argc, char *argv[])
+{
+/* =====  Variables  ===== */
+
+    hid_t fid;		/* file ID */
+    hid_t gid;          /* group ID */
+    hid_t did;          /* dataset ID */
+    hid_t sid;		/* dataspace ID */
+    hid_t gcpl;		/* group creation property list */
+
+    hsize_t dims[1];
+    int buf[ELINK_NELMTS];
+    char fname[32], oname[32], lname[32];
+    int i, j, k;
+
+/* =====  Main processing  ===== */
+
+   /* Create the sibling files */
+    dims[0] = ELINK_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    for(i = 0; i < ELINK_NFILES; i++) {
+        sprintf(fname, "elink_%d.h5", i);
+        fid = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+        for(j = 0; j < ELINK_PER_FILE; j++) {
+            for(k = 0; k < ELINK_NELMTS; k++)
+                buf[k] = i * 1000 + j * 10 + k;
+            sprintf(oname, "/d%d", j);
+            did = H5Dcreate(fid, oname, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+            H5Dclose(did);
+        }
+        H5Fclose(fid);
+    }
+    H5Sclose(sid);
+
+   /* Open File */
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, H5P_DEFAULT);
+
+   /* Create Group g6 */
+    gcpl = H5Pcreate(H5P_GROUP_CREATE);
+    H5Pset_link_creation_order(gcpl, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED);
+    gid = H5Gcreate2(fid, "/g6", H5P_DEFAULT, gcpl, H5P_DEFAULT);
+    H5Pclose(gcpl);
+
+   /* Link to every dataset of every sibling file */
+    for(j = 0; j < ELINK_PER_FILE; j++)
+        for(i = 0; i < ELINK_NFILES; i++) {
+            sprintf(fname, "elink_%d.h5", i);
+            sprintf(oname, "/d%d", j);
+            sprintf(lname, "e%d_%d", i, j);
+            H5Lcreate_external(fname, oname, gid, lname, H5P_DEFAULT, H5P_DEFAULT);
+        }
+
+   /* Close Group */
+    H5Gclose(gid);
+
+   /* Close File */
+    H5Fclose(fid);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_fill.c
+ *
+ *  Create one file per combination of layout, space allocation time and
+ *  fill value write time:
+ *
+ *      fill_<layout>_<alloc>_<fill>.h5
+ *
+ *          <layout>    contig or chunk (FILL_CHUNK elements per chunk)
+ *          <alloc>     early, incr or late (H5Pset_alloc_time)
+ *          <fill>      alloc, never or ifset (H5Pset_fill_time)
+ *
+ *  each holding /data, FILL_NELMTS integers with the fill value
+ *  FILL_VALUE (H5Pset_fill_value).  The file is closed, then opened again
+ *  to write the first FILL_NELMTS / FILL_WRITTEN_PART elements, element i
+ *  holding i; the rest is never written.
+ *
+ *  For each file these go to TIMEPATH:
+ *
+ *      <file>_create       creating the dataset and closing the file, in ms
+ *      <file>_size         file size after creating the dataset, in bytes
+ *      <file>_first_write  opening the file, the first write and closing
+ *                          it again, in ms
+ *      <file>_final_size   file size after the first write, in bytes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* The datasets, as in read_fill_compat.c */
+#ifndef FILL_NELMTS
+#define FILL_NELMTS         4194304
+#endif
+#define FILL_CHUNK          65536
+#define FILL_WRITTEN_PART   16
+#define FILL_VALUE          (-1)
+
+/* Record the size of file name */
+static void
+report_size(const char *name, const char *what)
+{
+    struct stat sb;
+
+    if(stat(name, &sb) == 0)
+        compat_timing_file("t_fill", name, what, (double)sb.st_size, "bytes");
+}
+
+/* Create file name with dataset creation property list dcpl, then write
+ * the first part of the dataset */
+static void
+create_file(const char *name, hid_t dcpl, int *buf)
+{
+    hid_t fid;		/* file ID */
+    hid_t sid;          /* dataspace ID */
+    hid_t mid;          /* memory dataspace ID */
+    hid_t did;          /* dataset ID */
+    hsize_t dims[1], start[1], count[1];
+    double t;
+
+    t = compat_time_now();
+    fid = H5Fcreate(name, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    dims[0] = FILL_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    did = H5Dcreate(fid, "/data", H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dclose(did);
+    H5Sclose(sid);
+    H5Fclose(fid);
+    compat_timing_file("t_fill", name, "create", (compat_time_now() - t) * 1000.0, "ms");
+    report_size(name, "size");
+
+    t = compat_time_now();
+    fid = H5Fopen(name, H5F_ACC_RDWR, H5P_DEFAULT);
+    did = H5Dopen(fid, "/data", H5P_DEFAULT);
+    sid = H5Dget_space(did);
+    start[0] = 0;
+    count[0] = FILL_NELMTS / FILL_WRITTEN_PART;
+    H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL);
+    mid = H5Screate_simple(1, count, NULL);
+    H5Dwrite(did, H5T_NATIVE_INT, mid, sid, H5P_DEFAULT, buf);
+    H5Sclose(mid);
+    H5Sclose(sid);
+    H5Dclose(did);
+    H5Fclose(fid);
+    compat_timing_file("t_fill", name, "first_write", (compat_time_now() - t) * 1000.0, "ms");
+    report_size(name, "final_size");
+}
+
+int main(int argc, char *argv[])
+{
+    hid_t dcpl;		/* dataset creation property list */
+    hsize_t chunk[1];
+    const char *layouts[2] = {"contig", "chunk"};
+    const char *allocs[3] = {"early", "incr", "late"};
+    const char *fills[3] = {"alloc", "never", "ifset"};
+    H5D_alloc_time_t alloc_times[3] = {H5D_ALLOC_TIME_EARLY, H5D_ALLOC_TIME_INCR, H5D_ALLOC_TIME_LATE};
+    H5D_fill_time_t fill_times[3] = {H5D_FILL_TIME_ALLOC, H5D_FILL_TIME_NEVER, H5D_FILL_TIME_IFSET};
+    char name[64];
+    int *buf, fill = FILL_VALUE;
+    int l, a, f, i;
+
+    buf = (int *)malloc(sizeof(int) * (FILL_NELMTS / FILL_WRITTEN_PART));
+    for(i = 0; i < FILL_NELMTS / FILL_WRITTEN_PART; i++)
+        buf[i] = i;
+
+    for(l = 0; l < 2; l++)
+        for(a = 0; a < 3; a++)
+            for(f = 0; f < 3; f++) {
+                dcpl = H5Pcreate(H5P_DATASET_CREATE);
+                if(l == 1) {
+                    chunk[0] = FILL_CHUNK;
+                    H5Pset_chunk(dcpl, 1, chunk);
+                }
+                H5Pset_alloc_time(dcpl, alloc_times[a]);
+                H5Pset_fill_time(dcpl, fill_times[f]);
+                H5Pset_fill_value(dcpl, H5T_NATIVE_INT, &fill);
+                sprintf(name, "fill_%s_%s_%s.h5", layouts[l], allocs[a], fills[f]);
+                create_file(name, dcpl, buf);
+                H5Pclose(dcpl);
+            }
+
+    free(buf);
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  Add one filtered dataset per filter pipeline to compat.h5, in the group
+ *  FILTER_GROUP:
+ *
+ *      deflate             deflate level 6
+ *      shuffle_deflate     shuffle, then deflate level 6
+ *      fletcher32          checksum only
+ *      nbit                n-bit on an 18-bit integer type
+ *      scaleoffset         integer scale-offset, minimum bits found by the
+ *                          library
+ *      szip                only if this library can encode szip
+ *
+ *  Each holds FILTER_NELMTS integers in chunks of FILTER_CHUNK, and element
+ *  k holds FILTER_VALUE(k), a slow ramp that fits in 18 bits.  The file is
+ *  opened with the default (earliest) format so that v1.6 can open the
+ *  datasets and find out which filters it can decode.
+ *
+ *  Encode throughput, storage sizes and compression ratios go to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include <stdlib.h>
+#include "../compat_timing.h"
+
+#define FILENAME "compat.h5"
+
+#define FILTER_GROUP "/filters"
+
+#ifndef FILTER_NELMTS
+#define FILTER_NELMTS   2097152
+#endif
+#define FILTER_CHUNK    65536
+
+/* The value of element k */
+#define FILTER_VALUE(k) ((int)(((k) / 16) % 262144))
+
+/* Bits used by FILTER_VALUE(), for the n-bit dataset's type */
+#define FILTER_PRECISION 18
+
+/* Create and write one dataset, and time the write */
+static void
+write_dset(hid_t gid, const char *name, hid_t ftid, hid_t dcpl, const int *buf)
+{
+    hid_t sid;		/* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hsize_t dims[1], chunk[1];
+    char metric[64];
+    double t, nbytes, storage;
+
+    dims[0] = FILTER_NELMTS;
+    chunk[0] = FILTER_NELMTS < FILTER_CHUNK ? FILTER_NELMTS : FILTER_CHUNK;
+    nbytes = (double)FILTER_NELMTS * sizeof(int);
+
+    sid = H5Screate_simple(1, dims, NULL);
+    H5Pset_chunk(dcpl, 1, chunk);
+
+    t = compat_time_now();
+    did = H5Dcreate(gid, name, ftid, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+    H5Dclose(did);
+    t = compat_time_now() - t;
+
+    did = H5Dopen(gid, name, H5P_DEFAULT);
+    storage = (double)H5Dget_storage_size(did);
+    H5Dclose(did);
+
+    sprintf(metric, "%s_encode", name);
+    compat_timing("t_filters", metric, compat_mbps(nbytes, t), "MB/s");
+    sprintf(metric, "%s_storage", name);
+    compat_timing("t_filters", metric, storage, "bytes");
+    sprintf(metric, "%s_ratio", name);
+    compat_timing("t_filters", metric, storage > 0.0 ? nbytes / storage : 0.0, "x");
+
+    H5Sclose(sid);
+}
+
+int main(int argc, char *argv[])
+{
+/* =====  Variables  ===== */
+
+    hid_t fid;		/* file ID */
+    hid_t gid;          /* group ID */
+    hid_t dcpl;		/* dataset creation property list */
+    hid_t nbit_tid;     /* n-bit datatype */
+
+    unsigned config;    /* szip filter configuration */
+    int *buf;
+    hsize_t k;
+
+/* =====  Main processing  ===== */
+
+    buf = (int *)malloc(sizeof(int) * FILTER_NELMTS);
+    for (k = 0; k < FILTER_NELMTS; k++)
+        buf[k] = FILTER_VALUE(k);
+
+   /* Open File, keeping the format v1.6 can read */
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, H5P_DEFAULT);
+
+   /* Create Group */
+    gid = H5Gcreate(fid, FILTER_GROUP, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_deflate(dcpl, 6);
+    write_dset(gid, "deflate", H5T_NATIVE_INT, dcpl, buf);
+    H5Pclose(dcpl);
+
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_shuffle(dcpl);
+    H5Pset_deflate(dcpl, 6);
+    write_dset(gid, "shuffle_deflate", H5T_NATIVE_INT, dcpl, buf);
+    H5Pclose(dcpl);
+
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_fletcher32(dcpl);
+    write_dset(gid, "fletcher32", H5T_NATIVE_INT, dcpl, buf);
+    H5Pclose(dcpl);
+
+    nbit_tid = H5Tcopy(H5T_NATIVE_INT);
+    H5Tset_precision(nbit_tid, FILTER_PRECISION);
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_nbit(dcpl);
+    write_dset(gid, "nbit", nbit_tid, dcpl, buf);
+    H5Pclose(dcpl);
+    H5Tclose(nbit_tid);
+
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_scaleoffset(dcpl, H5Z_SO_INT, H5Z_SO_INT_MINBITS_DEFAULT);
+    write_dset(gid, "scaleoffset", H5T_NATIVE_INT, dcpl, buf);
+    H5Pclose(dcpl);
+
+   /* szip is optional, and may be built without its encoder */
+    if(H5Zfilter_avail(H5Z_FILTER_SZIP) > 0
+            && H5Zget_filter_info(H5Z_FILTER_SZIP, &config) >= 0
+            && (config & H5Z_FILTER_CONFIG_ENCODE_ENABLED)) {
+        dcpl = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_szip(dcpl, H5_SZIP_NN_OPTION_MASK, 32);
+        write_dset(gid, "szip", H5T_NATIVE_INT, dcpl, buf);
+        H5Pclose(dcpl);
+    }
+
+   /* Close */
+    H5Gclose(gid);
+    H5Fclose(fid);
+
+    free(buf);
+
+    return 0;
+}
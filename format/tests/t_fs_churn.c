@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_fs_churn.c
+ *
+ *  Create the files churn_fs_compat.c deletes and recreates objects in:
+ *
+ *      fs_nopersist.h5     free space is not kept when the file is closed,
+ *                          the default
+ *      fs_persist.h5       free space is kept in the file
+ *                          (H5Pset_file_space_strategy(), persist=TRUE)
+ *
+ *  Each holds FSC_NDSETS contiguous datasets /d<n> of FSC_NELMTS integers,
+ *  element i of /d<n> holding n * FSC_NELMTS + i, and each dataset has
+ *  FSC_NATTRS attributes a<k> of FSC_ATTR_NELMTS integers, element j
+ *  holding n + k + j.  Persistent free space came with v1.10.1; older
+ *  writers only create fs_nopersist.h5.
+ *
+ *  Create times and file sizes go to TIMEPATH as <file>_create and
+ *  <file>_create_size; churn_fs_compat.c records the final <file>_size.
+ */
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* The objects, as in churn_fs_compat.c */
+#ifndef FSC_NDSETS
+#define FSC_NDSETS      32
+#endif
+#define FSC_NELMTS      4096
+#define FSC_NATTRS      8
+#define FSC_ATTR_NELMTS 16
+
+/* H5Pset_file_space_strategy() appeared in v1.10.1 */
+#if H5_VERS_MAJOR > 1 || (H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 1) || H5_VERS_MINOR > 10
+#define HAVE_PERSIST
+#endif
+
+/* Create one file with creation property list fcpl */
+static void
+create_file(const char *name, hid_t fcpl)
+{
+    hid_t fid;		/* file ID */
+    hid_t sid, asid;    /* dataspace IDs */
+    hid_t did;          /* dataset ID */
+    hid_t aid;          /* attribute ID */
+    hsize_t dims[1];
+    int buf[FSC_NELMTS], abuf[FSC_ATTR_NELMTS];
+    char oname[32];
+    struct stat sb;
+    double t;
+    int n, k, i;
+
+    t = compat_time_now();
+    fid = H5Fcreate(name, H5F_ACC_TRUNC, fcpl, H5P_DEFAULT);
+    dims[0] = FSC_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    dims[0] = FSC_ATTR_NELMTS;
+    asid = H5Screate_simple(1, dims, NULL);
+    for(n = 0; n < FSC_NDSETS; n++) {
+        for(i = 0; i < FSC_NELMTS; i++)
+            buf[i] = n * FSC_NELMTS + i;
+        sprintf(oname, "/d%d", n);
+        did = H5Dcreate(fid, oname, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+        for(k = 0; k < FSC_NATTRS; k++) {
+            for(i = 0; i < FSC_ATTR_NELMTS; i++)
+                abuf[i] = n + k + i;
+            sprintf(oname, "a%d", k);
+            aid = H5Acreate(did, oname, H5T_NATIVE_INT, asid, H5P_DEFAULT, H5P_DEFAULT);
+            H5Awrite(aid, H5T_NATIVE_INT, abuf);
+            H5Aclose(aid);
+        }
+        H5Dclose(did);
+    }
+    H5Sclose(asid);
+    H5Sclose(sid);
+    H5Fclose(fid);
+
+    compat_timing_file("t_fs_churn", name, "create", (compat_time_now() - t) * 1000.0, "ms");
+    if(stat(name, &sb) == 0)
+        compat_timing_file("t_fs_churn", name, "create_size", (double)sb.st_size, "bytes");
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef HAVE_PERSIST
+    hid_t fcpl;		/* file creation property list */
+
+   /* Same as the default, so the file stays in the v1.6 format */
+    fcpl = H5Pcreate(H5P_FILE_CREATE);
+    H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_FSM_AGGR, 0, (hsize_t)1);
+    create_file("fs_nopersist.h5", fcpl);
+    H5Pclose(fcpl);
+
+    fcpl = H5Pcreate(H5P_FILE_CREATE);
+    H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_FSM_AGGR, 1, (hsize_t)1);
+    create_file("fs_persist.h5", fcpl);
+    H5Pclose(fcpl);
+#else
+    create_file("fs_nopersist.h5", H5P_DEFAULT);
+#endif
+
+    return 0;
+}
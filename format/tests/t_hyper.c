@@ -20,19 +20,24 @@
  *  selection format change.
  *
  *  See gen_hyper_compat.c and read_hyper_compat.c.
+ *
+ *  Each reference the library can create is also stored HYPER_NREFS times
+ *  in <dataset>_scale (see compat_hyper.h), so that the readers can time
+ *  decoding it.  Create and write rates go to TIMEPATH.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include "hdf5.h"
+#include "../compat_timing.h"
+#include "../compat_hyper.h"
 
 #define POWER32     4294967296      /* 2^32 */
 
 /* The test file */
 #define FILENAME    "hyper_compat.h5"
 
-/* The existing dataset */
-#define DSET                "dset"
 
 /* Datasets added */
 #define ADD_REF_X_REG_DSET     "add_ref_x32_reg_dset"
@@ -75,7 +80,7 @@ main(int ac, char **av)
     fid = H5Fopen(FILENAME, H5F_ACC_RDWR, H5P_DEFAULT);
 
     /* Open the dataset */
-    did = H5Dopen2(fid, DSET, H5P_DEFAULT);
+    did = H5Dopen2(fid, HYPER_DSET, H5P_DEFAULT);
     sid = H5Dget_space(did);
 
     /* Create dataspace for the referenced dataset */
@@ -91,7 +96,7 @@ main(int ac, char **av)
 
     /* Create the first reference */
     H5E_BEGIN_TRY {
-        ret = H5Rcreate(&ref_wbuf[0], fid, DSET, H5R_DATASET_REGION, sid);
+        ret = H5Rcreate(&ref_wbuf[0], fid, HYPER_DSET, H5R_DATASET_REGION, sid);
     } H5E_END_TRY;
 
     /* Should succeed for v110 and above */
@@ -103,6 +108,9 @@ main(int ac, char **av)
 
         /* Write to the referenced datset */
         ret = H5Dwrite(ref_did1, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf);
+        assert(ret >= 0);
+        ret = hyper_write_scale(fid, ADD_REF_X_REG_DSET, sid);
+        assert(ret >= 0);
     } else
         /* Should fail for v18 and below */
         assert(ret < 0);
@@ -129,6 +137,9 @@ main(int ac, char **av)
 
         /* Write to the referenced datset */
         ret = H5Dwrite(ref_did2, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf);
+        assert(ret >= 0);
+        ret = hyper_write_scale(fid, ADD_REF_X_IRR_DSET, sid);
+        assert(ret >= 0);
     } else
         /* Should fail for v110 and below */
         assert(ret < 0);
@@ -154,6 +165,9 @@ main(int ac, char **av)
 
         /* Write to the referenced datset */
         ret = H5Dwrite(ref_did3, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, ref_wbuf);
+        assert(ret >= 0);
+        ret = hyper_write_scale(fid, ADD_REF_X_PT_DSET, sid);
+        assert(ret >= 0);
     } else
         /* Should fail for v110 and below */
         assert(ret < 0);
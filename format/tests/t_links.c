@@ -0,0 +1,126 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_links.c
+ *
+ *  Create groups of 10, 100, ... LINKS_MAX soft links, each group size
+ *  stored three ways:
+ *
+ *      links_v16.h5:/symtab_<n>    the default symbol table group, as v1.6
+ *                                  writes it
+ *      links_v16.h5:/crt_<n>       link messages, compact up to
+ *                                  LINKS_MAX_COMPACT links and dense
+ *                                  (fractal heap and v2 B-tree) beyond
+ *                                  that (H5Pset_link_phase_change), with
+ *                                  creation order tracked and indexed
+ *                                  (H5Pset_link_creation_order)
+ *      links_v18.h5:/name_<n>      as /crt_<n>, without creation order
+ *
+ *  Tracking creation order makes a group hold link messages even in a file
+ *  in the default format, so v1.6 readers meet the /crt_<n> groups next to
+ *  the ones they can read.  Without creation order, groups only hold link
+ *  messages when the file's low format bound is v1.8, hence the second
+ *  file.
+ *
+ *  The k-th link created in a group of n is named l<m>, m = k * LINKS_STRIDE
+ *  mod n written with seven digits, so name order and creation order
+ *  differ.  The links point to "/nowhere"; they are only looked up, never
+ *  followed.
+ *
+ *  The time to fill each group goes to TIMEPATH.
+ */
+
+#include <stdio.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* HDF5 v1.8 defined H5F_LIBVER_18, but doesn't have H5F_LIBVER_V18.
+ * See tests/t_newdata.c.
+ */
+#if defined(H5F_LIBVER_18)
+#define H5F_LIBVER_V18 H5F_LIBVER_18
+#endif
+
+/* The groups, as in read_links_compat.c */
+#ifndef LINKS_MAX
+#define LINKS_MAX           100000
+#endif
+#define LINKS_STRIDE        7919
+#define LINKS_MAX_COMPACT   16
+#define LINKS_MIN_DENSE     12
+
+/* Create group name with creation property list gcpl and fill it with n
+ * links */
+static void
+create_group(hid_t fid, const char *name, hid_t gcpl, long n)
+{
+    hid_t gid;          /* group ID */
+    char lname[32], metric[64];
+    double t;
+    long k;
+
+    t = compat_time_now();
+    gid = H5Gcreate(fid, name, H5P_DEFAULT, gcpl, H5P_DEFAULT);
+    for(k = 0; k < n; k++) {
+        sprintf(lname, "l%07ld", k * LINKS_STRIDE % n);
+        H5Lcreate_soft("/nowhere", gid, lname, H5P_DEFAULT, H5P_DEFAULT);
+    }
+    H5Gclose(gid);
+
+    sprintf(metric, "%s_create", name + 1);
+    compat_timing("t_links", metric, (compat_time_now() - t) * 1000.0, "ms");
+}
+
+int main(int argc, char *argv[])
+{
+    hid_t fid;		/* file ID */
+    hid_t fid_v18;	/* file ID, v1.8 format */
+    hid_t fapl;		/* file access property list */
+    hid_t gcpl_name;	/* group creation property list, by name */
+    hid_t gcpl_crt;	/* group creation property list, creation order */
+    char name[32];
+    long n;
+
+    fid = H5Fcreate("links_v16.h5", H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if(H5F_LIBVER_LATEST > 1)
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+    else
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    fid_v18 = H5Fcreate("links_v18.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    H5Pclose(fapl);
+
+    gcpl_name = H5Pcreate(H5P_GROUP_CREATE);
+    H5Pset_link_phase_change(gcpl_name, LINKS_MAX_COMPACT, LINKS_MIN_DENSE);
+    gcpl_crt = H5Pcopy(gcpl_name);
+    H5Pset_link_creation_order(gcpl_crt, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED);
+
+    for(n = 10; n <= LINKS_MAX; n *= 10) {
+        sprintf(name, "/symtab_%ld", n);
+        create_group(fid, name, H5P_DEFAULT, n);
+        sprintf(name, "/crt_%ld", n);
+        create_group(fid, name, gcpl_crt, n);
+        sprintf(name, "/name_%ld", n);
+        create_group(fid_v18, name, gcpl_name, n);
+    }
+
+    H5Pclose(gcpl_crt);
+    H5Pclose(gcpl_name);
+    H5Fclose(fid_v18);
+    H5Fclose(fid);
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_lock.c
+ *
+ *  Open compat.h5 for writing and hold it open for LOCK_HOLD seconds (or
+ *  the number of seconds given as the first argument) while
+ *  read_lock_compat.c readers contend with it.  Halfway through, dset2 is
+ *  rewritten in place with LOCK_DSET2_NEW added to every value gen_compat.c
+ *  wrote, so a reader sees either the old or the new dset2 and can tell
+ *  which.
+ *
+ *  LOCK_READY is created once the file is open, which tells
+ *  check_format.sh to start the readers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "hdf5.h"
+
+#define FILENAME "compat.h5"
+
+/* Marker file created once the writer holds the file */
+#define LOCK_READY  "lock_ready"
+
+/* Default number of seconds to hold the file open */
+#define LOCK_HOLD   5
+
+/* Added to every value of dset2; read_lock_compat.c checks for it */
+#define LOCK_DSET2_NEW  1000
+
+/* HDF5 v1.8 defined H5F_LIBVER_18, but doesn't have H5F_LIBVER_V18.
+ * See tests/t_newdata.c.
+ */
+#if defined(H5F_LIBVER_18)
+#define H5F_LIBVER_V18 H5F_LIBVER_18
+#endif
+
+int main(int argc, char *argv[])
+{
+/* =====  Variables  ===== */
+
+    hid_t fid;		/* file ID */
+    hid_t did;          /* dataset ID */
+
+    hid_t fapl;		/* file access property list */
+
+    FILE *rp;           /* ready marker */
+
+    int dset2[10][10];
+    int hold = LOCK_HOLD;
+    int i, j;
+
+/* =====  Main processing  ===== */
+
+    if(argc > 1)
+        hold = atoi(argv[1]);
+
+   /* Open File */
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if(H5F_LIBVER_LATEST > 1)
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+    else
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, fapl);
+
+   /* Tell check_format.sh that the file is held */
+    if((rp = fopen(LOCK_READY, "w")) != NULL)
+        fclose(rp);
+
+   /* Hold the file open, rewriting dset2 in place halfway through */
+    sleep((unsigned)(hold / 2));
+    did = H5Dopen(fid, "/g4/dset2", H5P_DEFAULT);
+    for (i = 0; i < 10; i++)
+        for (j = 0; j < 10; j++)
+            dset2[i][j] = LOCK_DSET2_NEW + j + 10 * i;
+    H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dset2);
+    H5Dclose(did);
+    H5Fflush(fid, H5F_SCOPE_GLOBAL);
+    sleep((unsigned)(hold - hold / 2));
+
+   /* Close everything */
+    H5Fclose(fid);
+    H5Pclose(fapl);
+
+    return 0;
+
+}
@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_mdc_image.c
+ *
+ *  Create the same many-object file twice, in the v1.8 format:
+ *
+ *      mdci_plain.h5   closed normally
+ *      mdci_image.h5   closed with a metadata cache image
+ *                      (H5Pset_mdc_image_config), which later opens load
+ *                      in one read instead of warming up the cache
+ *
+ *  Each holds MDCI_NGROUPS groups /g<i>, each with MDCI_NDSETS datasets
+ *  d<j> of MDCI_NELMTS integers, element k holding i + j + k.  Cache
+ *  images came with v1.10.1; older writers only create mdci_plain.h5.
+ *
+ *  Create times go to TIMEPATH.
+ */
+
+#include <stdio.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* The objects, as in read_mdc_image_compat.c */
+#ifndef MDCI_NGROUPS
+#define MDCI_NGROUPS    64
+#endif
+#define MDCI_NDSETS     64
+#define MDCI_NELMTS     16
+
+/* HDF5 v1.8 defined H5F_LIBVER_18, but doesn't have H5F_LIBVER_V18.
+ * See tests/t_newdata.c.
+ */
+#if defined(H5F_LIBVER_18)
+#define H5F_LIBVER_V18 H5F_LIBVER_18
+#endif
+
+/* H5Pset_mdc_image_config() appeared in v1.10.1 */
+#if H5_VERS_MAJOR > 1 || (H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 1) || H5_VERS_MINOR > 10
+#define HAVE_CACHE_IMAGE
+#endif
+
+/* Create one file with access property list fapl */
+static void
+create_file(const char *name, hid_t fapl)
+{
+    hid_t fid;		/* file ID */
+    hid_t gid;          /* group ID */
+    hid_t sid;          /* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hsize_t dims[1];
+    int buf[MDCI_NELMTS];
+    char oname[32];
+    double t;
+    int i, j, k;
+
+    t = compat_time_now();
+    fid = H5Fcreate(name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    dims[0] = MDCI_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    for(i = 0; i < MDCI_NGROUPS; i++) {
+        sprintf(oname, "/g%d", i);
+        gid = H5Gcreate(fid, oname, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        for(j = 0; j < MDCI_NDSETS; j++) {
+            for(k = 0; k < MDCI_NELMTS; k++)
+                buf[k] = i + j + k;
+            sprintf(oname, "d%d", j);
+            did = H5Dcreate(gid, oname, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+            H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+            H5Dclose(did);
+        }
+        H5Gclose(gid);
+    }
+    H5Sclose(sid);
+    H5Fclose(fid);
+
+    compat_timing_file("t_mdc_image", name, "create", (compat_time_now() - t) * 1000.0, "ms");
+}
+
+int main(int argc, char *argv[])
+{
+    hid_t fapl;		/* file access property list */
+#ifdef HAVE_CACHE_IMAGE
+    H5AC_cache_image_config_t config;
+#endif
+
+   /* A cache image needs a superblock extension, so both files use at
+    * least the v1.8 format */
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if(H5F_LIBVER_LATEST > 1)
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+    else
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    create_file("mdci_plain.h5", fapl);
+
+#ifdef HAVE_CACHE_IMAGE
+    config.version = H5AC__CURR_CACHE_IMAGE_CONFIG_VERSION;
+    config.generate_image = 1;
+    config.save_resize_status = 0;
+    config.entry_ageout = H5AC__CACHE_IMAGE__ENTRY_AGEOUT__NONE;
+    H5Pset_mdc_image_config(fapl, &config);
+    create_file("mdci_image.h5", fapl);
+#endif
+
+    H5Pclose(fapl);
+
+    return 0;
+}
@@ -13,6 +13,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "hdf5.h"
+#include "../compat_dset1.h"
 
 #define FILENAME "compat.h5"
 
@@ -55,26 +56,12 @@ int main(int argc, char *argv[])
     hid_t sid;		/* dataspace ID */
     hid_t tid;   	/* datatype ID */
     hid_t dcpl;		/* dataset creation property list */
-    hid_t array_dt;	/* */
 
     hid_t fapl;		/* file access property list */
 
     hsize_t dims[2];
 
-    int j;
-    int i0, i1, i2, i3;
-    hsize_t sdim, maxdim;
-
-    typedef struct { /* compound type has members with rank > 1 */
-      int a[2][2][2][2]; /* arrays are 2x2x2x2    */
-      double b[2][2][2][2];
-      double c[2][2][2][2];
-    } dset1_t;
-    dset1_t dset1[6];
-
-    hsize_t dim[4];
-    int idx[4] = {0,1,2,3};  /* normal indicies */
-    const int perm[4] = {0,1,2,3};  /* the 0'th and the 3'rd indices are permuted */
+    hsize_t sdim, maxdim, chunk;
 
 /* =====  Main processing  ===== */
 
@@ -93,20 +80,7 @@ int main(int argc, char *argv[])
     H5Ldelete(gid, "dtype1", H5P_DEFAULT);
 
    /* Create Datatype tid */
-    dim[0] = dim[1] = dim[2] = dim[3] = 2;
-    tid = H5Tcreate(H5T_COMPOUND, sizeof(dset1_t));
-
-    array_dt = H5Tarray_create(H5T_NATIVE_INT, 4, dim);
-    H5Tinsert(tid, "a_array", HOFFSET(dset1_t, a), array_dt);
-    H5Tclose(array_dt);
-
-    array_dt = H5Tarray_create(H5T_NATIVE_DOUBLE, 4, dim);
-    H5Tinsert(tid, "b_array", HOFFSET(dset1_t, b), array_dt);
-    H5Tclose(array_dt);
-
-    array_dt = H5Tarray_create(H5T_NATIVE_DOUBLE, 4, dim);
-    H5Tinsert(tid, "c_array", HOFFSET(dset1_t, c), array_dt);
-    H5Tclose(array_dt);
+    tid = dset1_create_type();
 
    /* Save datatype as a named datatype */
     H5Tcommit(gid, "dtype1", tid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
@@ -138,40 +112,18 @@ int main(int argc, char *argv[])
     H5Ldelete(gid, "dset1", H5P_DEFAULT);
 
    /* Create Dataspace */
-    sdim = 6;
+    sdim = DSET1_NELMTS;
     maxdim = H5S_UNLIMITED;
     sid = H5Screate_simple(1, &sdim, &maxdim);
 
    /* Create Dataset dset1 */
     dcpl = H5Pcreate(H5P_DATASET_CREATE);
-    H5Pset_chunk(dcpl, 1, &sdim);
+    chunk = dset1_chunk_size(sdim);
+    H5Pset_chunk(dcpl, 1, &chunk);
     did = H5Dcreate(gid, "dset1", tid, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
 
    /* Write to Dataset dset1 */
-    for (j=0; j<(int)sdim; j++) {
-      for (i3 = 0; i3 < 2; i3++) {
-        idx[perm[3]] = i3;
-        for (i2 = 0; i2 < 2; i2++) {
-          idx[perm[2]] = i2;
-          for (i1 = 0; i1 < 2; i1++) {
-            idx[perm[1]] = i1;
-            for (i0 = 0; i0 < 2; i0++) {
-              idx[perm[0]] = i0;
-
-		dset1[j].a[idx[3]][idx[2]][idx[1]][idx[0]] = i0+j;
-		dset1[j].b[idx[3]][idx[2]][idx[1]][idx[0]] = (double)(i0+j);
-	      #ifdef WIN32
-		dset1[j].c[idx[3]][idx[2]][idx[1]][idx[0]] = (double)(i0+j+(signed __int64)sdim);
-	      #else
-		dset1[j].c[idx[3]][idx[2]][idx[1]][idx[0]] = (double)(i0+j+sdim);
-	      #endif
-	    }
-	  }
-	}
-      }
-    }
-
-    H5Dwrite(did, tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, dset1);
+    dset1_write(did, tid, sdim);
 
    /* Close some things */
     H5Dclose(did);
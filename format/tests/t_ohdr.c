@@ -0,0 +1,110 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_ohdr.c
+ *
+ *  Create the files ohdr_stress_compat.c rewrites attributes in:
+ *
+ *      ohdr_v16.h5     the default format, v1 object headers
+ *      ohdr_v18.h5     the v1.8 format, v2 object headers, with the
+ *                      attributes kept in the header rather than in dense
+ *                      storage (H5Pset_attr_phase_change)
+ *
+ *  Each holds OHDR_NOBJS datasets /d<n> of one integer, each with
+ *  OHDR_NATTRS attributes attr<k>, k written with five digits.  Attribute
+ *  attr<k> holds L integers, L between 1 and OHDR_MAXLEN, element j
+ *  holding k * 1000 + j; the stress runs change L but keep that rule.
+ *
+ *  Create times go to TIMEPATH.
+ */
+
+#include <stdio.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* HDF5 v1.8 defined H5F_LIBVER_18, but doesn't have H5F_LIBVER_V18.
+ * See tests/t_newdata.c.
+ */
+#if defined(H5F_LIBVER_18)
+#define H5F_LIBVER_V18 H5F_LIBVER_18
+#endif
+
+/* The objects, as in ohdr_stress_compat.c */
+#define OHDR_NOBJS      8
+#define OHDR_NATTRS     20
+#define OHDR_MAXLEN     64
+
+/* Create one file with access property list fapl, its datasets with
+ * creation property list dcpl */
+static void
+create_file(const char *name, hid_t fapl, hid_t dcpl)
+{
+    hid_t fid;		/* file ID */
+    hid_t sid;          /* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hid_t aid;          /* attribute ID */
+    hsize_t dims[1];
+    int buf[OHDR_MAXLEN], value = 0;
+    char oname[32];
+    double t;
+    int n, k, j;
+
+    t = compat_time_now();
+    fid = H5Fcreate(name, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    for(n = 0; n < OHDR_NOBJS; n++) {
+        sid = H5Screate(H5S_SCALAR);
+        sprintf(oname, "/d%d", n);
+        did = H5Dcreate(fid, oname, H5T_NATIVE_INT, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &value);
+        H5Sclose(sid);
+        for(k = 0; k < OHDR_NATTRS; k++) {
+            dims[0] = (hsize_t)(1 + k % OHDR_MAXLEN);
+            for(j = 0; j < (int)dims[0]; j++)
+                buf[j] = k * 1000 + j;
+            sid = H5Screate_simple(1, dims, NULL);
+            sprintf(oname, "attr%05d", k);
+            aid = H5Acreate(did, oname, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT);
+            H5Awrite(aid, H5T_NATIVE_INT, buf);
+            H5Aclose(aid);
+            H5Sclose(sid);
+        }
+        H5Dclose(did);
+    }
+    H5Fclose(fid);
+
+    compat_timing_file("t_ohdr", name, "create", (compat_time_now() - t) * 1000.0, "ms");
+}
+
+int main(int argc, char *argv[])
+{
+    hid_t fapl;		/* file access property list */
+    hid_t dcpl;		/* dataset creation property list */
+
+    create_file("ohdr_v16.h5", H5P_DEFAULT, H5P_DEFAULT);
+
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+    if(H5F_LIBVER_LATEST > 1)
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+    else
+        H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_attr_phase_change(dcpl, OHDR_NATTRS * 2, OHDR_NATTRS);
+    create_file("ohdr_v18.h5", fapl, dcpl);
+    H5Pclose(dcpl);
+    H5Pclose(fapl);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_paged.c
+ *
+ *  Create the same small-object file with each file space strategy:
+ *
+ *      paged_aggr.h5   the default strategy (aggregation)
+ *      paged_4k.h5     paged aggregation, 4 KB pages
+ *      paged_64k.h5    paged aggregation, 64 KB pages
+ *      paged_1m.h5     paged aggregation, 1 MB pages
+ *
+ *  Each holds PAGED_NDSETS datasets /d<n> of PAGED_NELMTS integers, element
+ *  i of /d<n> holding n * PAGED_NELMTS + i.  Paged aggregation came with
+ *  v1.10.1; older writers only create paged_aggr.h5.
+ *
+ *  Create times go to TIMEPATH.
+ */
+
+#include <stdio.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* The datasets, as in read_paged_compat.c */
+#ifndef PAGED_NDSETS
+#define PAGED_NDSETS    512
+#endif
+#define PAGED_NELMTS    256
+
+/* H5Pset_file_space_strategy() appeared in v1.10.1 */
+#if H5_VERS_MAJOR > 1 || (H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 1) || H5_VERS_MINOR > 10
+#define HAVE_PAGED_AGGREGATION
+#endif
+
+/* Create one file with creation property list fcpl */
+static void
+create_file(const char *name, hid_t fcpl)
+{
+    hid_t fid;		/* file ID */
+    hid_t sid;          /* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hsize_t dims[1];
+    int buf[PAGED_NELMTS];
+    char dname[32];
+    double t;
+    int n, i;
+
+    t = compat_time_now();
+    fid = H5Fcreate(name, H5F_ACC_TRUNC, fcpl, H5P_DEFAULT);
+    dims[0] = PAGED_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    for(n = 0; n < PAGED_NDSETS; n++) {
+        for(i = 0; i < PAGED_NELMTS; i++)
+            buf[i] = n * PAGED_NELMTS + i;
+        sprintf(dname, "/d%d", n);
+        did = H5Dcreate(fid, dname, H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+        H5Dclose(did);
+    }
+    H5Sclose(sid);
+    H5Fclose(fid);
+
+    compat_timing_file("t_paged", name, "create", (compat_time_now() - t) * 1000.0, "ms");
+}
+
+int main(int argc, char *argv[])
+{
+#ifdef HAVE_PAGED_AGGREGATION
+    hid_t fcpl;		/* file creation property list */
+    hsize_t page_sizes[3] = {4096, 65536, 1048576};
+    const char *names[3] = {"paged_4k.h5", "paged_64k.h5", "paged_1m.h5"};
+    int p;
+#endif
+
+    create_file("paged_aggr.h5", H5P_DEFAULT);
+
+#ifdef HAVE_PAGED_AGGREGATION
+    for(p = 0; p < 3; p++) {
+        fcpl = H5Pcreate(H5P_FILE_CREATE);
+        H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_PAGE, 0, (hsize_t)1);
+        H5Pset_file_space_page_size(fcpl, page_sizes[p]);
+        create_file(names[p], fcpl);
+        H5Pclose(fcpl);
+    }
+#endif
+
+    return 0;
+}
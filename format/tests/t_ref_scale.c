@@ -0,0 +1,202 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on library release versions 1.8 and later with:
+ *      h5cc tests/t_ref_scale.c
+ *
+ *  Add REF_COUNT object references and REF_COUNT dataset region references
+ *  to ref_compat.h5, in the group REF_GROUP:
+ *
+ *      t0 .. t<REF_NTARGETS - 1>   scalar integer datasets holding their
+ *                                  own number, the object reference targets
+ *      region_target               REF_TARGET_NELMTS integers, element k
+ *                                  holding k, the region reference target
+ *      old_object                  object references with the old type,
+ *                                  reference k to t<k % REF_NTARGETS>
+ *      old_region                  region references with the old type,
+ *                                  reference k to REF_REGION_LEN(k)
+ *                                  elements from REF_REGION_START(k)
+ *
+ *  With library release 1.12 and later, the same references are also
+ *  written with the revised reference type (H5R_ref_t), as revised_object
+ *  and revised_region.
+ *
+ *  Create and write times go to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "../compat_timing.h"
+
+/* The test file */
+#define FILENAME "ref_compat.h5"
+
+#define REF_GROUP "/Refs"
+
+/* References in each dataset */
+#ifndef REF_COUNT
+#define REF_COUNT           65536
+#endif
+
+/* Objects referred to */
+#define REF_NTARGETS        64
+
+/* Elements in the region reference target */
+#define REF_TARGET_NELMTS   4096
+
+/* The selection of region reference k, as in read_ref_scale_compat.c */
+#define REF_REGION_START(k) ((k) % (REF_TARGET_NELMTS - 8))
+#define REF_REGION_LEN(k)   (1 + (k) % 8)
+
+/* Time the create loop and the write of one reference dataset */
+static void
+report(const char *dname, double create, double write)
+{
+    char metric[64];
+
+    sprintf(metric, "%s_create", dname);
+    compat_timing("t_ref_scale", metric, create > 0.0 ? REF_COUNT / create : 0.0, "refs/s");
+    sprintf(metric, "%s_write", dname);
+    compat_timing("t_ref_scale", metric, write > 0.0 ? REF_COUNT / write : 0.0, "refs/s");
+}
+
+int main(int argc, char *argv[])
+{
+    hid_t fid = -1;         /* File ID */
+    hid_t gid = -1;         /* Group ID */
+    hid_t did = -1;         /* Dataset ID */
+    hid_t sid = -1;         /* Dataspace ID */
+    hid_t ref_sid = -1;     /* Dataspace ID of the reference datasets */
+    hid_t target_sid = -1;  /* Dataspace ID of region_target */
+    hsize_t ref_dims[1], target_dims[1];
+    hsize_t start[1], count[1], block[1];
+    hobj_ref_t *obj_wbuf;
+    hdset_reg_ref_t *reg_wbuf;
+#if H5_VERS_MINOR >= 12
+    H5R_ref_t *wbuf;        /* Revised references */
+#endif
+    char names[REF_NTARGETS][32];
+    int *dwbuf;
+    int i;
+    unsigned long k;
+    double t, tw;
+
+    obj_wbuf = (hobj_ref_t *)malloc(sizeof(hobj_ref_t) * REF_COUNT);
+    reg_wbuf = (hdset_reg_ref_t *)malloc(sizeof(hdset_reg_ref_t) * REF_COUNT);
+    dwbuf = (int *)malloc(sizeof(int) * REF_TARGET_NELMTS);
+
+    /* Open the test file */
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, H5P_DEFAULT);
+    gid = H5Gcreate2(fid, REF_GROUP, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    /* Create the targets */
+    sid = H5Screate(H5S_SCALAR);
+    for(i = 0; i < REF_NTARGETS; i++) {
+        sprintf(names[i], "%s/t%d", REF_GROUP, i);
+        did = H5Dcreate2(fid, names[i], H5T_NATIVE_INT, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &i);
+        H5Dclose(did);
+    }
+    H5Sclose(sid);
+
+    target_dims[0] = REF_TARGET_NELMTS;
+    target_sid = H5Screate_simple(1, target_dims, NULL);
+    for(i = 0; i < REF_TARGET_NELMTS; i++)
+        dwbuf[i] = i;
+    did = H5Dcreate2(gid, "region_target", H5T_NATIVE_INT, target_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(did, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, dwbuf);
+    H5Dclose(did);
+
+    ref_dims[0] = REF_COUNT;
+    ref_sid = H5Screate_simple(1, ref_dims, NULL);
+    count[0] = 1;
+
+    /* Object references with the old type */
+    t = compat_time_now();
+    for(k = 0; k < REF_COUNT; k++)
+        H5Rcreate(&obj_wbuf[k], fid, names[k % REF_NTARGETS], H5R_OBJECT, -1);
+    t = compat_time_now() - t;
+    tw = compat_time_now();
+    did = H5Dcreate2(gid, "old_object", H5T_STD_REF_OBJ, ref_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(did, H5T_STD_REF_OBJ, H5S_ALL, H5S_ALL, H5P_DEFAULT, obj_wbuf);
+    H5Dclose(did);
+    report("old_object", t, compat_time_now() - tw);
+
+    /* Region references with the old type; each one is stored in the
+     * global heap as it is created */
+    t = compat_time_now();
+    for(k = 0; k < REF_COUNT; k++) {
+        start[0] = REF_REGION_START(k);
+        block[0] = REF_REGION_LEN(k);
+        H5Sselect_hyperslab(target_sid, H5S_SELECT_SET, start, NULL, count, block);
+        H5Rcreate(&reg_wbuf[k], fid, REF_GROUP "/region_target", H5R_DATASET_REGION, target_sid);
+    }
+    t = compat_time_now() - t;
+    tw = compat_time_now();
+    did = H5Dcreate2(gid, "old_region", H5T_STD_REF_DSETREG, ref_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(did, H5T_STD_REF_DSETREG, H5S_ALL, H5S_ALL, H5P_DEFAULT, reg_wbuf);
+    H5Dclose(did);
+    report("old_region", t, compat_time_now() - tw);
+
+#if H5_VERS_MINOR >= 12
+    wbuf = (H5R_ref_t *)malloc(sizeof(H5R_ref_t) * REF_COUNT);
+
+    /* Object references with the revised type */
+    t = compat_time_now();
+    for(k = 0; k < REF_COUNT; k++)
+        H5Rcreate_object(fid, names[k % REF_NTARGETS], H5P_DEFAULT, &wbuf[k]);
+    t = compat_time_now() - t;
+    tw = compat_time_now();
+    did = H5Dcreate2(gid, "revised_object", H5T_STD_REF, ref_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(did, H5T_STD_REF, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf);
+    H5Dclose(did);
+    report("revised_object", t, compat_time_now() - tw);
+    for(k = 0; k < REF_COUNT; k++)
+        H5Rdestroy(&wbuf[k]);
+
+    /* Region references with the revised type, which keep their selection
+     * in memory until they are written */
+    t = compat_time_now();
+    for(k = 0; k < REF_COUNT; k++) {
+        start[0] = REF_REGION_START(k);
+        block[0] = REF_REGION_LEN(k);
+        H5Sselect_hyperslab(target_sid, H5S_SELECT_SET, start, NULL, count, block);
+        H5Rcreate_region(fid, REF_GROUP "/region_target", target_sid, H5P_DEFAULT, &wbuf[k]);
+    }
+    t = compat_time_now() - t;
+    tw = compat_time_now();
+    did = H5Dcreate2(gid, "revised_region", H5T_STD_REF, ref_sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(did, H5T_STD_REF, H5S_ALL, H5S_ALL, H5P_DEFAULT, wbuf);
+    H5Dclose(did);
+    report("revised_region", t, compat_time_now() - tw);
+    for(k = 0; k < REF_COUNT; k++)
+        H5Rdestroy(&wbuf[k]);
+
+    free(wbuf);
+#endif
+
+    /* Closing */
+    H5Sclose(ref_sid);
+    H5Sclose(target_sid);
+    H5Gclose(gid);
+    H5Fclose(fid);
+
+    free(obj_wbuf);
+    free(reg_wbuf);
+    free(dwbuf);
+
+    return 0;
+}
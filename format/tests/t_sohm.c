@@ -0,0 +1,143 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_sohm.c
+ *
+ *  Create the same file of many small, uniform datasets with different
+ *  shared object header message settings:
+ *
+ *      sohm_none.h5    no sharing, the default; every dataset stores its
+ *                      own datatype, dataspace and fill value messages
+ *      sohm_one.h5     one index for all three message types
+ *      sohm_three.h5   one index per message type
+ *
+ *  Each holds SOHM_NDSETS datasets /d<n> of SOHM_NELMTS sohm_t records,
+ *  all with the same datatype, dataspace and fill value.  Element k of
+ *  /d<n> holds id = n * SOHM_NELMTS + k, x = id / 2.0 and y = -x.
+ *
+ *  Create times go to TIMEPATH.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+/* The datasets, as in read_sohm_compat.c */
+#ifndef SOHM_NDSETS
+#define SOHM_NDSETS     20000
+#endif
+#define SOHM_NELMTS     8
+
+typedef struct {
+    int id;
+    double x;
+    double y;
+    float weight;
+    short flags;
+    char tag[12];
+} sohm_t;
+
+/* The record type, with a description long enough to be worth sharing */
+static hid_t
+sohm_type(void)
+{
+    hid_t tid, str;
+
+    str = H5Tcopy(H5T_C_S1);
+    H5Tset_size(str, (size_t)12);
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(sohm_t));
+    H5Tinsert(tid, "id", HOFFSET(sohm_t, id), H5T_NATIVE_INT);
+    H5Tinsert(tid, "x", HOFFSET(sohm_t, x), H5T_NATIVE_DOUBLE);
+    H5Tinsert(tid, "y", HOFFSET(sohm_t, y), H5T_NATIVE_DOUBLE);
+    H5Tinsert(tid, "weight", HOFFSET(sohm_t, weight), H5T_NATIVE_FLOAT);
+    H5Tinsert(tid, "flags", HOFFSET(sohm_t, flags), H5T_NATIVE_SHORT);
+    H5Tinsert(tid, "tag", HOFFSET(sohm_t, tag), str);
+    H5Tclose(str);
+
+    return tid;
+}
+
+/* Create one file with creation property list fcpl */
+static void
+create_file(const char *name, hid_t fcpl)
+{
+    hid_t fid;		/* file ID */
+    hid_t sid;          /* dataspace ID */
+    hid_t did;          /* dataset ID */
+    hid_t tid;          /* datatype ID */
+    hid_t dcpl;         /* dataset creation property list */
+    hsize_t dims[1];
+    sohm_t buf[SOHM_NELMTS], fill;
+    char dname[32];
+    double t;
+    int n, k;
+
+    t = compat_time_now();
+    fid = H5Fcreate(name, H5F_ACC_TRUNC, fcpl, H5P_DEFAULT);
+    tid = sohm_type();
+    dims[0] = SOHM_NELMTS;
+    sid = H5Screate_simple(1, dims, NULL);
+    memset(&fill, 0, sizeof(fill));
+    fill.id = -1;
+    strcpy(fill.tag, "unset");
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_fill_value(dcpl, tid, &fill);
+    memset(buf, 0, sizeof(buf));
+    for(n = 0; n < SOHM_NDSETS; n++) {
+        for(k = 0; k < SOHM_NELMTS; k++) {
+            buf[k].id = n * SOHM_NELMTS + k;
+            buf[k].x = buf[k].id / 2.0;
+            buf[k].y = -buf[k].x;
+            buf[k].weight = 1.0f;
+            strcpy(buf[k].tag, "sohm");
+        }
+        sprintf(dname, "/d%d", n);
+        did = H5Dcreate(fid, dname, tid, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        H5Dwrite(did, tid, H5S_ALL, H5S_ALL, H5P_DEFAULT, buf);
+        H5Dclose(did);
+    }
+    H5Pclose(dcpl);
+    H5Sclose(sid);
+    H5Tclose(tid);
+    H5Fclose(fid);
+
+    compat_timing_file("t_sohm", name, "create", (compat_time_now() - t) * 1000.0, "ms");
+}
+
+int main(int argc, char *argv[])
+{
+    hid_t fcpl;		/* file creation property list */
+
+    create_file("sohm_none.h5", H5P_DEFAULT);
+
+   /* Share even the smallest messages; the dataspace is only a few bytes */
+    fcpl = H5Pcreate(H5P_FILE_CREATE);
+    H5Pset_shared_mesg_nindexes(fcpl, 1);
+    H5Pset_shared_mesg_index(fcpl, 0, H5O_SHMESG_DTYPE_FLAG | H5O_SHMESG_SDSPACE_FLAG | H5O_SHMESG_FILL_FLAG, 0);
+    create_file("sohm_one.h5", fcpl);
+    H5Pclose(fcpl);
+
+    fcpl = H5Pcreate(H5P_FILE_CREATE);
+    H5Pset_shared_mesg_nindexes(fcpl, 3);
+    H5Pset_shared_mesg_index(fcpl, 0, H5O_SHMESG_DTYPE_FLAG, 0);
+    H5Pset_shared_mesg_index(fcpl, 1, H5O_SHMESG_SDSPACE_FLAG, 0);
+    H5Pset_shared_mesg_index(fcpl, 2, H5O_SHMESG_FILL_FLAG, 0);
+    create_file("sohm_three.h5", fcpl);
+    H5Pclose(fcpl);
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  This can be compiled on all library release versions (except v16) with:
+ *      h5cc tests/t_swmr.c
+ *
+ *  Create swmr_compat.h5 with an empty chunked dataset, SWMR_DSET, switch
+ *  to SWMR writing and create SWMR_READY, which tells check_format.sh to
+ *  start the read_swmr_compat.c readers.  After SWMR_SETTLE seconds,
+ *  append SWMR_NAPPENDS records one at a time, SWMR_INTERVAL_USEC apart,
+ *  flushing each.  Record k holds k and the time it was written, so that
+ *  the readers can tell how long it took to become visible to them.
+ *
+ *  SWMR came with v1.10; a v1.8 writer only creates SWMR_READY, and the
+ *  readers find no file.
+ *
+ *  The time each append takes, H5Dset_extent() to H5Dflush(), goes to
+ *  TIMEPATH.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "hdf5.h"
+#include "../compat_timing.h"
+
+#define FILENAME "swmr_compat.h5"
+
+/* Marker file created once the file is open for SWMR writing */
+#define SWMR_READY  "swmr_ready"
+
+/* The dataset, as in read_swmr_compat.c */
+#define SWMR_DSET   "/append"
+#ifndef SWMR_NAPPENDS
+#define SWMR_NAPPENDS       2000
+#endif
+
+#define SWMR_CHUNK          256     /* Records per chunk */
+#define SWMR_INTERVAL_USEC  2000    /* Microseconds between appends */
+#define SWMR_SETTLE         2       /* Seconds for the readers to open */
+
+typedef struct {
+    long long seq;      /* Record number */
+    double stamp;       /* Wall clock time it was written */
+} swmr_record_t;
+
+int main(int argc, char *argv[])
+{
+    FILE *rp;           /* ready marker */
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 10
+    hid_t fid;		/* file ID */
+    hid_t fapl;		/* file access property list */
+    hid_t dcpl;		/* dataset creation property list */
+    hid_t tid;          /* record datatype ID */
+    hid_t sid;          /* dataspace ID */
+    hid_t mid;          /* memory dataspace ID */
+    hid_t did;          /* dataset ID */
+    hsize_t dims[1], maxdims[1], chunk[1], start[1], count[1];
+    swmr_record_t rec;
+    double *latency;
+    double t;
+    int k;
+
+    latency = (double *)malloc(sizeof(double) * SWMR_NAPPENDS);
+
+   /* Create the file in the v1.10 format, which SWMR needs and every
+    * SWMR reader can open */
+    fapl = H5Pcreate(H5P_FILE_ACCESS);
+#if H5_VERSION_GE(1,10,2)
+    H5Pset_libver_bounds(fapl, H5F_LIBVER_V110, H5F_LIBVER_V110);
+#else
+    H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+#endif
+    fid = H5Fcreate(FILENAME, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+
+    tid = H5Tcreate(H5T_COMPOUND, sizeof(swmr_record_t));
+    H5Tinsert(tid, "seq", HOFFSET(swmr_record_t, seq), H5T_NATIVE_LLONG);
+    H5Tinsert(tid, "stamp", HOFFSET(swmr_record_t, stamp), H5T_NATIVE_DOUBLE);
+
+    dims[0] = 0;
+    maxdims[0] = H5S_UNLIMITED;
+    chunk[0] = SWMR_CHUNK;
+    sid = H5Screate_simple(1, dims, maxdims);
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, 1, chunk);
+    did = H5Dcreate2(fid, SWMR_DSET, tid, sid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Sclose(sid);
+    H5Pclose(dcpl);
+
+    H5Fstart_swmr_write(fid);
+#endif
+
+   /* Tell check_format.sh to start the readers */
+    if((rp = fopen(SWMR_READY, "w")) != NULL)
+        fclose(rp);
+
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 10
+    sleep(SWMR_SETTLE);
+
+   /* Append one record at a time */
+    count[0] = 1;
+    mid = H5Screate_simple(1, count, NULL);
+    for(k = 0; k < SWMR_NAPPENDS; k++) {
+        t = compat_time_now();
+        dims[0] = (hsize_t)k + 1;
+        H5Dset_extent(did, dims);
+        sid = H5Dget_space(did);
+        start[0] = (hsize_t)k;
+        H5Sselect_hyperslab(sid, H5S_SELECT_SET, start, NULL, count, NULL);
+        rec.seq = k;
+        rec.stamp = compat_time_now();
+        H5Dwrite(did, tid, mid, sid, H5P_DEFAULT, &rec);
+        H5Sclose(sid);
+        H5Dflush(did);
+        latency[k] = compat_time_now() - t;
+        usleep(SWMR_INTERVAL_USEC);
+    }
+    H5Sclose(mid);
+
+    qsort(latency, (size_t)SWMR_NAPPENDS, sizeof(double), compat_cmp_double);
+    compat_timing("t_swmr", "append_p50", latency[SWMR_NAPPENDS / 2] * 1000.0, "ms");
+    compat_timing("t_swmr", "append_p99", latency[SWMR_NAPPENDS * 99 / 100] * 1000.0, "ms");
+    compat_timing("t_swmr", "append_max", latency[SWMR_NAPPENDS - 1] * 1000.0, "ms");
+
+   /* Let the readers see the last records before closing */
+    sleep(SWMR_SETTLE);
+
+   /* Close */
+    H5Dclose(did);
+    H5Tclose(tid);
+    H5Fclose(fid);
+    H5Pclose(fapl);
+    free(latency);
+#endif
+
+    return 0;
+}
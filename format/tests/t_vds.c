@@ -0,0 +1,106 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  Add two virtual datasets over the source files from gen_vds_compat.c to
+ *  vds_compat.h5, each holding the value k at element k:
+ *
+ *      /vds_explicit   one mapping per source file, VDS_NSOURCES in all
+ *      /vds_printf     a single unlimited mapping to the printf-style
+ *                      source file name "vds_src_%b.h5", which the reader
+ *                      resolves to the source files it finds
+ *
+ *  Virtual datasets came with v1.10; a v1.8 writer adds nothing, so the
+ *  readers find neither dataset.
+ *
+ *  Create times go to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include <stdio.h>
+#include "../compat_timing.h"
+
+#define FILENAME "vds_compat.h5"
+
+/* The source files, as in gen_vds_compat.c */
+#define VDS_SRC_FILE    "vds_src_%d.h5"
+#define VDS_SRC_PRINTF  "vds_src_%b.h5"
+#define VDS_SRC_DSET    "/data"
+
+#ifndef VDS_NSOURCES
+#define VDS_NSOURCES    256
+#endif
+#define VDS_SRC_NELMTS  16384
+
+int main(int argc, char *argv[])
+{
+#if H5_VERS_MAJOR > 1 || H5_VERS_MINOR >= 10
+    hid_t fid;		/* file ID */
+    hid_t vsid;         /* virtual dataspace ID */
+    hid_t ssid;         /* source dataspace ID */
+    hid_t dcpl;		/* dataset creation property list */
+    hid_t did;          /* dataset ID */
+    hsize_t dims[1], maxdims[1];
+    hsize_t start[1], stride[1], count[1], block[1];
+    char name[64];
+    int s;
+    double t;
+
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, H5P_DEFAULT);
+
+    dims[0] = VDS_SRC_NELMTS;
+    ssid = H5Screate_simple(1, dims, NULL);
+
+   /* One mapping per source file */
+    t = compat_time_now();
+    dims[0] = (hsize_t)VDS_NSOURCES * VDS_SRC_NELMTS;
+    vsid = H5Screate_simple(1, dims, NULL);
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    count[0] = 1;
+    block[0] = VDS_SRC_NELMTS;
+    for(s = 0; s < VDS_NSOURCES; s++) {
+        start[0] = (hsize_t)s * VDS_SRC_NELMTS;
+        H5Sselect_hyperslab(vsid, H5S_SELECT_SET, start, NULL, count, block);
+        sprintf(name, VDS_SRC_FILE, s);
+        H5Pset_virtual(dcpl, vsid, name, VDS_SRC_DSET, ssid);
+    }
+    did = H5Dcreate2(fid, "/vds_explicit", H5T_NATIVE_INT, vsid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dclose(did);
+    H5Pclose(dcpl);
+    H5Sclose(vsid);
+    compat_timing("t_vds", "vds_explicit_create", (compat_time_now() - t) * 1000.0, "ms");
+
+   /* One unlimited mapping with a printf-style source file name */
+    t = compat_time_now();
+    maxdims[0] = H5S_UNLIMITED;
+    vsid = H5Screate_simple(1, dims, maxdims);
+    dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    start[0] = 0;
+    stride[0] = VDS_SRC_NELMTS;
+    count[0] = H5S_UNLIMITED;
+    H5Sselect_hyperslab(vsid, H5S_SELECT_SET, start, stride, count, block);
+    H5Pset_virtual(dcpl, vsid, VDS_SRC_PRINTF, VDS_SRC_DSET, ssid);
+    did = H5Dcreate2(fid, "/vds_printf", H5T_NATIVE_INT, vsid, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Dclose(did);
+    H5Pclose(dcpl);
+    H5Sclose(vsid);
+    compat_timing("t_vds", "vds_printf_create", (compat_time_now() - t) * 1000.0, "ms");
+
+   /* Close */
+    H5Sclose(ssid);
+    H5Fclose(fid);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5.  The full HDF5 copyright notice, including     *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic HDF5 document set and   *
+ * is linked from the top-level documents page.  It can also be found at     *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have          *
+ * access to either file, you may request a copy from help@hdfgroup.org.     *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ *  Add the variable-length fixture of compat_vlen.h to vlen_compat.h5, from
+ *  gen_vlen_compat.c, in the group VLEN_GROUP.  The file keeps the format
+ *  v1.6 can read, so every reader sees the global heap collections this
+ *  writer creates next to those v1.6 created.
+ *
+ *  The write rates go to TIMEPATH.
+ */
+
+#include "hdf5.h"
+#include "../compat_timing.h"
+#include "../compat_vlen.h"
+
+#define FILENAME "vlen_compat.h5"
+
+#define VLEN_GROUP "/mod"
+
+int main(int argc, char *argv[])
+{
+    hid_t fid;		/* file ID */
+    hid_t gid;          /* group ID */
+    double t;
+
+   /* Open File, keeping the format v1.6 can read */
+    fid = H5Fopen(FILENAME, H5F_ACC_RDWR, H5P_DEFAULT);
+    gid = H5Gcreate(fid, VLEN_GROUP, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    t = compat_time_now();
+    vlen_write_strings(gid, (hsize_t)VLEN_NELMTS, 0);
+    compat_timing("t_vlen", "mod_strings_write", (double)VLEN_NELMTS / (compat_time_now() - t), "elmts/s");
+
+    t = compat_time_now();
+    vlen_write_sequences(gid, (hsize_t)VLEN_NELMTS);
+    compat_timing("t_vlen", "mod_sequences_write", (double)VLEN_NELMTS / (compat_time_now() - t), "elmts/s");
+
+    vlen_write_strings(gid, (hsize_t)VLEN_NATTR, 1);
+
+   /* Close */
+    H5Gclose(gid);
+    H5Fclose(fid);
+
+    return 0;
+}